@@ -0,0 +1,239 @@
+#include "AnimationBaker.h"
+#include "Common/Log.h"
+#include "Common/ParallelFor.h"
+
+#include <algorithm>
+#include <math.h>
+
+// Translation, rotation and scaling, X, Y and Z, for every sample of a node.
+static const int BAKE_CHANNEL_COUNT = 9;
+
+static const char* const gComponents[3] =
+{
+    FBXSDK_CURVENODE_COMPONENT_X, FBXSDK_CURVENODE_COMPONENT_Y, FBXSDK_CURVENODE_COMPONENT_Z
+};
+
+static FbxPropertyT<FbxDouble3>& GetTransformProperty(FbxNode* pNode, int pProperty)
+{
+    return pProperty == 0 ? pNode->LclTranslation : pProperty == 1 ? pNode->LclRotation : pNode->LclScaling;
+}
+
+static bool HasTransformCurves(FbxNode* pNode, FbxAnimLayer* pLayer)
+{
+    for (int p = 0; p < 3; ++p)
+    {
+        if (GetTransformProperty(pNode, p).GetCurveNode(pLayer))
+            return true;
+    }
+    return false;
+}
+
+/** Disconnect and destroy a property's curve node on one layer, and its curves. */
+static void RemoveCurveNode(FbxPropertyT<FbxDouble3>& pProperty, FbxAnimLayer* pLayer)
+{
+    FbxAnimCurveNode* lCurveNode = pProperty.GetCurveNode(pLayer);
+    if (!lCurveNode)
+        return;
+
+    for (unsigned int c = 0; c < lCurveNode->GetChannelsCount(); ++c)
+    {
+        for (int j = lCurveNode->GetCurveCount(c) - 1; j >= 0; --j)
+        {
+            FbxAnimCurve* lCurve = lCurveNode->GetCurve(c, j);
+            lCurveNode->DisconnectFromChannel(lCurve, c);
+            if (lCurve->GetDstObjectCount<FbxAnimCurveNode>() == 0)
+                lCurve->Destroy();
+        }
+    }
+    lCurveNode->Destroy();
+}
+
+/** Whether the nodes' evaluation can be split between workers. Evaluators cache
+  * the last key index inside each curve, so two workers must never read the same
+  * curve. A constraint evaluates the curves of its source nodes, and a curve or
+  * curve node connected to several properties is read for each of them.
+  */
+static bool CanEvaluateInParallel(FbxScene* pScene, const std::vector<FbxNode*>& pNodes,
+                                  const std::vector<SceneTableLayer>& pLayers, size_t pFirst, size_t pLast)
+{
+    if (pScene->GetSrcObjectCount<FbxConstraint>() > 0)
+        return false;
+
+    for (size_t n = 0; n < pNodes.size(); ++n)
+    {
+        for (int p = 0; p < 3; ++p)
+        {
+            for (size_t l = pFirst; l < pLast; ++l)
+            {
+                FbxAnimCurveNode* lCurveNode = GetTransformProperty(pNodes[n], p).GetCurveNode(pLayers[l].mLayer);
+                if (!lCurveNode)
+                    continue;
+                if (lCurveNode->GetDstPropertyCount() > 1)
+                    return false;
+                for (unsigned int c = 0; c < lCurveNode->GetChannelsCount(); ++c)
+                {
+                    for (int j = 0; j < lCurveNode->GetCurveCount(c); ++j)
+                    {
+                        if (lCurveNode->GetCurve(c, j)->GetDstPropertyCount() > 1)
+                            return false;
+                    }
+                }
+            }
+        }
+    }
+    return true;
+}
+
+static void WriteCurve(FbxAnimCurve* pCurve, const std::vector<FbxTime>& pTimes, const float* pValues)
+{
+    pCurve->KeyModifyBegin();
+    pCurve->KeyClear();
+    int lLast = 0;
+    for (size_t t = 0; t < pTimes.size(); ++t)
+    {
+        const int lKey = pCurve->KeyAdd(pTimes[t], &lLast);
+        pCurve->KeySet(lKey, pTimes[t], pValues[t * BAKE_CHANNEL_COUNT], FbxAnimCurveDef::eInterpolationLinear);
+    }
+    pCurve->KeyModifyEnd();
+}
+
+static void GetSampleTimes(FbxAnimStack* pStack, double pFrameRate, std::vector<FbxTime>& pTimes)
+{
+    const FbxTimeSpan lSpan = pStack->GetLocalTimeSpan();
+    const double lStart = lSpan.GetStart().GetSecondDouble();
+    const double lStop = std::max(lStart, lSpan.GetStop().GetSecondDouble());
+
+    // Each time is computed from the start so that rounding does not accumulate.
+    const long long lFrames = (long long)floor((lStop - lStart) * pFrameRate + 1e-6);
+    pTimes.resize((size_t)lFrames + 1);
+    for (long long i = 0; i <= lFrames; ++i)
+        pTimes[(size_t)i].SetSecondDouble(lStart + i / pFrameRate);
+
+    // Keep the last pose when the span is not a whole number of frames.
+    if (pTimes.back() < lSpan.GetStop())
+        pTimes.push_back(lSpan.GetStop());
+}
+
+/** Bake the nodes animated on one stack. pFirst..pLast are the stack's layers. */
+static void BakeStack(FbxScene* pScene, const SceneTable& pTable, size_t pFirst, size_t pLast, double pFrameRate,
+                      std::vector<FbxAnimEvaluator*>& pEvaluators, BakeResult& pResult)
+{
+    const std::vector<SceneTableNode>& lTableNodes = pTable.GetNodes();
+    const std::vector<SceneTableLayer>& lLayers = pTable.GetLayers();
+    FbxAnimStack* lStack = lLayers[pFirst].mStack;
+
+    std::vector<FbxNode*> lNodes;
+    for (size_t i = 0; i < lTableNodes.size(); ++i)
+    {
+        for (size_t l = pFirst; l < pLast; ++l)
+        {
+            if (HasTransformCurves(lTableNodes[i].mNode, lLayers[l].mLayer))
+            {
+                lNodes.push_back(lTableNodes[i].mNode);
+                break;
+            }
+        }
+    }
+    if (lNodes.empty())
+        return;
+
+    std::vector<FbxTime> lTimes;
+    GetSampleTimes(lStack, pFrameRate, lTimes);
+    const size_t lNodeSamples = lTimes.size() * BAKE_CHANNEL_COUNT;
+    std::vector<float> lSamples(lNodes.size() * lNodeSamples);
+
+    // The evaluators work on the current stack and cache per node state.
+    pScene->SetCurrentAnimationStack(lStack);
+    for (size_t w = 0; w < pEvaluators.size(); ++w)
+        pEvaluators[w]->Reset();
+
+    size_t lWorkers = std::min(pEvaluators.size(), lNodes.size());
+    if (lWorkers > 1 && !CanEvaluateInParallel(pScene, lNodes, lLayers, pFirst, pLast))
+    {
+        LOG_INFO("Stack %s has constraints or shared curves, evaluating on one thread\n", lStack->GetName());
+        lWorkers = 1;
+    }
+    ParallelFor(lWorkers, 1, (int)lWorkers, [&](size_t begin, size_t end)
+    {
+        for (size_t w = begin; w < end; ++w)
+        {
+            FbxAnimEvaluator* lEvaluator = pEvaluators[w];
+            const size_t lEnd = (w + 1) * lNodes.size() / lWorkers;
+            for (size_t n = w * lNodes.size() / lWorkers; n < lEnd; ++n)
+            {
+                float* lOut = &lSamples[n * lNodeSamples];
+                for (size_t t = 0; t < lTimes.size(); ++t, lOut += BAKE_CHANNEL_COUNT)
+                {
+                    const FbxVector4 lT = lEvaluator->GetNodeLocalTranslation(lNodes[n], lTimes[t]);
+                    const FbxVector4 lR = lEvaluator->GetNodeLocalRotation(lNodes[n], lTimes[t]);
+                    const FbxVector4 lS = lEvaluator->GetNodeLocalScaling(lNodes[n], lTimes[t]);
+                    for (int c = 0; c < 3; ++c)
+                    {
+                        lOut[c] = (float)lT[c];
+                        lOut[3 + c] = (float)lR[c];
+                        lOut[6 + c] = (float)lS[c];
+                    }
+                }
+            }
+        }
+    });
+
+    // Write the keys serially: creating curves and curve nodes changes connections.
+    FbxAnimLayer* lBaseLayer = lLayers[pFirst].mLayer;
+    FbxAnimCurveFilterUnroll lUnroll;
+    for (size_t n = 0; n < lNodes.size(); ++n)
+    {
+        FbxAnimCurve* lRotation[3];
+        for (int p = 0; p < 3; ++p)
+        {
+            FbxPropertyT<FbxDouble3>& lProperty = GetTransformProperty(lNodes[n], p);
+            for (int c = 0; c < 3; ++c)
+            {
+                FbxAnimCurve* lCurve = lProperty.GetCurve(lBaseLayer, gComponents[c], true);
+                WriteCurve(lCurve, lTimes, &lSamples[n * lNodeSamples + p * 3 + c]);
+                if (p == 1)
+                    lRotation[c] = lCurve;
+            }
+            for (size_t l = pFirst + 1; l < pLast; ++l)
+                RemoveCurveNode(lProperty, lLayers[l].mLayer);
+        }
+        // Evaluated Euler angles can wrap between samples.
+        lUnroll.Apply(lRotation, 3);
+    }
+
+    ++pResult.mStacks;
+    pResult.mNodes += (int)lNodes.size();
+    pResult.mKeys += (long long)lNodes.size() * lNodeSamples;
+    LOG_INFO("Baked Stack %s: %d nodes, %d samples\n", lStack->GetName(), (int)lNodes.size(), (int)lTimes.size());
+}
+
+void BakeSceneAnimation(FbxScene* pScene, const SceneTable& pTable, double pFrameRate, int pThreads, BakeResult& pResult)
+{
+    const std::vector<SceneTableLayer>& lLayers = pTable.GetLayers();
+    if (lLayers.empty() || pFrameRate <= 0.0)
+        return;
+
+    // Creating objects is not thread safe, so every worker's evaluator is made here.
+    std::vector<FbxAnimEvaluator*> lEvaluators(ResolveThreadCount(pThreads));
+    for (size_t w = 0; w < lEvaluators.size(); ++w)
+        lEvaluators[w] = FbxAnimEvalClassic::Create(pScene, "BakeEvaluator");
+
+    FbxAnimStack* lCurrentStack = pScene->GetCurrentAnimationStack();
+
+    // Layers of a stack are consecutive in the table.
+    for (size_t lFirst = 0; lFirst < lLayers.size(); )
+    {
+        size_t lLast = lFirst + 1;
+        while (lLast < lLayers.size() && lLayers[lLast].mStack == lLayers[lFirst].mStack)
+            ++lLast;
+        BakeStack(pScene, pTable, lFirst, lLast, pFrameRate, lEvaluators, pResult);
+        lFirst = lLast;
+    }
+
+    for (size_t w = 0; w < lEvaluators.size(); ++w)
+        lEvaluators[w]->Destroy();
+
+    if (lCurrentStack)
+        pScene->SetCurrentAnimationStack(lCurrentStack);
+    pScene->GetAnimationEvaluator()->Reset();
+}
@@ -0,0 +1,39 @@
+#ifndef _ANIMATION_BAKER_H
+#define _ANIMATION_BAKER_H
+
+#include <fbxsdk.h>
+#include "SceneTable.h"
+
+struct BakeResult
+{
+    BakeResult() : mStacks(0), mNodes(0), mKeys(0) {}
+
+    int mStacks;
+    int mNodes;                 // Summed over stacks.
+    long long mKeys;
+};
+
+/** Resample the local translation, rotation and scaling of every animated node
+  * at a fixed rate and replace their curves with linear keys.
+  *
+  * For each stack, every node with a transform curve on any of its layers is
+  * evaluated at pFrameRate over the stack's local time span, blending all
+  * layers. The result is written to the stack's first layer, and the node's
+  * transform curves on the other layers are removed. Other animated properties
+  * are left as they are.
+  *
+  * Evaluation is split into contiguous node ranges, one per worker, each with
+  * its own evaluator. Evaluating a curve updates a cache inside it, so this is
+  * only done when no two nodes can read the same curve. A scene with constraints,
+  * or a stack where a transform curve or curve node drives several properties, is
+  * evaluated on one thread. Keys are written afterwards on the calling thread.
+  *
+  * /param pScene The scene to bake.
+  * /param pTable The scene's table; it is stale afterwards and must be rebuilt.
+  * /param pFrameRate Samples per second.
+  * /param pThreads Worker threads; 0 uses one per hardware thread.
+  * /param pResult Receives stack, node and key counts.
+  */
+void BakeSceneAnimation(FbxScene* pScene, const SceneTable& pTable, double pFrameRate, int pThreads, BakeResult& pResult);
+
+#endif // #ifndef _ANIMATION_BAKER_H
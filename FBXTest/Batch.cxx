@@ -0,0 +1,332 @@
+#include "Batch.h"
+#include "BuildState.h"
+#include "Common/Common.h"
+#include "Common/Hash64.h"
+#include "Common/FileUtility.h"
+#include "Common/Log.h"
+#include "Common/ParallelFor.h"
+#include "ResultCache.h"
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct BatchJob
+{
+    BatchJob() : mSize(0), mModified(0), mHash(0), mResult(false), mUpToDate(false) {}
+
+    std::string mInput;
+    std::string mOutput;
+    long long mSize;
+    long long mModified;
+    unsigned long long mHash;   // Only computed for incremental batches.
+    bool mResult;
+    bool mUpToDate;             // Unchanged since the recorded run; not processed again.
+    FileProfile mProfile;
+};
+
+// FbxManager creation and destruction touch SDK globals (class registry,
+// plugins), so only one worker at a time may set up or tear down its manager.
+static std::mutex gSdkLifetimeMutex;
+
+static bool CollectInputs(const BatchOptions& pOptions, std::vector<BatchJob>& pJobs)
+{
+    std::vector<std::string> lInputs;
+    std::vector<std::string> lOutputs;
+    const std::string& lSpec = pOptions.mInput;
+
+    if (!lSpec.empty() && lSpec[0] == '@')
+    {
+        std::ifstream lManifest(lSpec.c_str() + 1);
+        if (!lManifest)
+        {
+            LOG_ERROR("Error: Unable to open manifest %s\n", lSpec.c_str() + 1);
+            return false;
+        }
+
+        std::string lLine;
+        while (std::getline(lManifest, lLine))
+        {
+            if (!lLine.empty() && lLine[lLine.size() - 1] == '\r')
+                lLine.erase(lLine.size() - 1);
+            if (lLine.empty() || lLine[0] == '#')
+                continue;
+
+            size_t lTab = lLine.find('\t');
+            lInputs.push_back(lLine.substr(0, lTab));
+            lOutputs.push_back(lTab == std::string::npos ? std::string() : lLine.substr(lTab + 1));
+        }
+    }
+    else
+    {
+        std::string lDirectory = lSpec;
+        std::string lPattern = "*.fbx";
+        if (!IsDirectory(lSpec.c_str()))
+            SplitPath(lSpec, lDirectory, lPattern);
+
+        std::vector<std::string> lFiles;
+        if (!ListDirectory(lDirectory.c_str(), lFiles))
+        {
+            LOG_ERROR("Error: Unable to list directory %s\n", lDirectory.c_str());
+            return false;
+        }
+
+        for (size_t i = 0; i < lFiles.size(); ++i)
+        {
+            std::string lDummy, lFileName;
+            SplitPath(lFiles[i], lDummy, lFileName);
+            if (WildcardMatch(lPattern.c_str(), lFileName.c_str()))
+            {
+                lInputs.push_back(lFiles[i]);
+                lOutputs.push_back(std::string());
+            }
+        }
+    }
+
+    for (size_t i = 0; i < lInputs.size(); ++i)
+    {
+        BatchJob lJob;
+        lJob.mInput = lInputs[i];
+        lJob.mOutput = lOutputs[i];
+        if (lJob.mOutput.empty())
+        {
+            std::string lDummy, lFileName;
+            SplitPath(lJob.mInput, lDummy, lFileName);
+            lJob.mOutput = JoinPath(pOptions.mOutputDirectory, lFileName);
+        }
+        lJob.mSize = GetFileSize(lJob.mInput.c_str());
+        lJob.mModified = GetFileModificationTime(lJob.mInput.c_str());
+        pJobs.push_back(lJob);
+    }
+
+    return true;
+}
+
+/** Mark jobs whose input, joint map, options and output match their record.
+  * Size and modification time are checked first; the input is only hashed when
+  * they differ, e.g. after a fresh checkout, to tell a touched file from an edited one.
+  */
+static int MarkUpToDate(std::vector<BatchJob>& pJobs, BuildState& pState,
+                        unsigned long long pJointMapHash, unsigned long long pOptionsHash)
+{
+    int lCount = 0;
+    for (size_t i = 0; i < pJobs.size(); ++i)
+    {
+        BatchJob& lJob = pJobs[i];
+        const BuildRecord* lRecord = pState.Find(lJob.mInput);
+        if (!lRecord || lRecord->mOutput != lJob.mOutput || lRecord->mJointMapHash != pJointMapHash ||
+            lRecord->mOptionsHash != pOptionsHash || lRecord->mSize != lJob.mSize ||
+            GetFileSize(lJob.mOutput.c_str()) < 0)
+            continue;
+
+        if (lRecord->mModified != lJob.mModified)
+        {
+            unsigned long long lHash;
+            if (!HashFile(lJob.mInput.c_str(), lHash) || lHash != lRecord->mHash)
+                continue;
+
+            BuildRecord lTouched = *lRecord;
+            lTouched.mModified = lJob.mModified;
+            pState.Update(lTouched);
+        }
+
+        lJob.mUpToDate = true;
+        lJob.mResult = true;
+        ++lCount;
+    }
+    return lCount;
+}
+
+static void BatchWorker(std::vector<BatchJob>& pJobs, std::atomic<size_t>& pNextJob,
+                        const PipelineOptions& pPipelineOptions, const JointMap& pJointMap, bool pProfile,
+                        bool pHashInputs)
+{
+    FbxManager* lManager = NULL;
+    FbxScene* lScene = NULL;
+
+    // Native renaming works on the files directly and needs no SDK objects.
+    const bool lUseSdk = !pPipelineOptions.mNativeRename;
+    if (lUseSdk)
+    {
+        std::lock_guard<std::mutex> lLock(gSdkLifetimeMutex);
+        InitializeSdkObjects(lManager, lScene);
+    }
+
+    for (size_t i = pNextJob++; i < pJobs.size(); i = pNextJob++)
+    {
+        BatchJob& lJob = pJobs[i];
+        if (lJob.mUpToDate)
+            continue;
+
+        // Hash before processing, so the record describes the bytes that were read.
+        if (pHashInputs)
+            HashFile(lJob.mInput.c_str(), lJob.mHash);
+
+        // With -arena, everything the job allocates lives in its own chunks.
+        BeginAllocationArena();
+        lJob.mResult = ProcessFile(lManager, lScene, lJob.mInput.c_str(), lJob.mOutput.c_str(), pPipelineOptions, pJointMap,
+                                   pProfile ? &lJob.mProfile : NULL);
+
+        // Start the next file from a clean scene; the manager stays alive.
+        if (lUseSdk)
+        {
+            lScene->Destroy();
+            EndAllocationArena();
+            lScene = FbxScene::Create(lManager, "My Scene");
+        }
+        else
+        {
+            EndAllocationArena();
+        }
+    }
+
+    if (lUseSdk)
+    {
+        std::lock_guard<std::mutex> lLock(gSdkLifetimeMutex);
+        DestroySdkObjects(lManager, false);
+    }
+    LogReleaseThread();
+}
+
+bool RunBatch(const BatchOptions& pOptions, const PipelineOptions& pPipelineOptions,
+              const JointMap& pJointMap)
+{
+    std::vector<BatchJob> lJobs;
+    if (!CollectInputs(pOptions, lJobs))
+        return false;
+
+    if (lJobs.empty())
+    {
+        LOG_ERROR("No input files match %s\n", pOptions.mInput.c_str());
+        return false;
+    }
+
+    if (!MakeDirectory(pOptions.mOutputDirectory.c_str()))
+    {
+        LOG_ERROR("Error: Unable to create output directory %s\n", pOptions.mOutputDirectory.c_str());
+        return false;
+    }
+
+    const bool lIncremental = !pOptions.mStateFile.empty();
+    const unsigned long long lJointMapHash = pJointMap.GetContentHash();
+    const unsigned long long lOptionsHash = Hash64(GetOptionsKey(pPipelineOptions));
+    BuildState lState;
+    int lUpToDate = 0;
+    if (lIncremental)
+    {
+        if (!lState.Load(pOptions.mStateFile.c_str()))
+            return false;
+        lUpToDate = MarkUpToDate(lJobs, lState, lJointMapHash, lOptionsHash);
+        LOG_INFO("Incremental: %d of %d files up to date\n", lUpToDate, (int)lJobs.size());
+    }
+
+    const size_t lPending = lJobs.size() - lUpToDate;
+    int lWorkerCount = ResolveThreadCount(pOptions.mWorkers);
+    if ((size_t)lWorkerCount > lPending)
+        lWorkerCount = (int)lPending;
+
+    LOG_INFO("Batch: %d files, %d workers\n", (int)lPending, lWorkerCount);
+
+    std::chrono::steady_clock::time_point lStart = std::chrono::steady_clock::now();
+
+    // Workers share the console, so a protected file fails instead of prompting.
+    PipelineOptions lWorkerOptions = pPipelineOptions;
+    lWorkerOptions.mPromptPassword = false;
+
+    // Files already run in parallel, so each worker bakes and scales on at most its
+    // share of the cores instead of starting a thread per core for every layer.
+    int lCoreShare = ResolveThreadCount(0) / (lWorkerCount > 0 ? lWorkerCount : 1);
+    if (lCoreShare < 1)
+        lCoreShare = 1;
+    if (ResolveThreadCount(lWorkerOptions.mScaleThreads) > lCoreShare)
+    {
+        LOG_INFO("Scale threads limited to %d per worker\n", lCoreShare);
+        lWorkerOptions.mScaleThreads = lCoreShare;
+    }
+
+    std::atomic<size_t> lNextJob(0);
+    std::vector<std::thread> lWorkers;
+    for (int i = 0; i < lWorkerCount; ++i)
+    {
+        lWorkers.push_back(std::thread(BatchWorker, std::ref(lJobs), std::ref(lNextJob),
+                                       std::cref(lWorkerOptions), std::cref(pJointMap), !pOptions.mProfileReport.empty(),
+                                       lIncremental));
+    }
+    for (size_t i = 0; i < lWorkers.size(); ++i)
+    {
+        lWorkers[i].join();
+    }
+
+    double lSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - lStart).count();
+
+    int lSucceeded = 0;
+    long long lBytes = 0;
+    for (size_t i = 0; i < lJobs.size(); ++i)
+    {
+        if (lJobs[i].mUpToDate)
+        {
+            ++lSucceeded;
+            continue;
+        }
+
+        // Failed inputs lose their record, so the next run retries them.
+        if (lIncremental && lJobs[i].mResult)
+        {
+            BuildRecord lRecord;
+            lRecord.mInput = lJobs[i].mInput;
+            lRecord.mOutput = lJobs[i].mOutput;
+            lRecord.mSize = lJobs[i].mSize;
+            lRecord.mModified = lJobs[i].mModified;
+            lRecord.mHash = lJobs[i].mHash;
+            lRecord.mJointMapHash = lJointMapHash;
+            lRecord.mOptionsHash = lOptionsHash;
+            lState.Update(lRecord);
+        }
+        else if (lIncremental)
+        {
+            lState.Remove(lJobs[i].mInput);
+        }
+
+        if (lJobs[i].mResult)
+        {
+            ++lSucceeded;
+        }
+        else
+        {
+            LOG_ERROR("Failed: %s\n", lJobs[i].mInput.c_str());
+        }
+        if (lJobs[i].mSize > 0)
+            lBytes += lJobs[i].mSize;
+    }
+
+    if (lIncremental && !lState.Save(pOptions.mStateFile.c_str()))
+        LOG_ERROR("Error: Unable to write build state %s\n", pOptions.mStateFile.c_str());
+
+    double lMegabytes = lBytes / (1024.0 * 1024.0);
+    LOG_INFO("\nBatch finished: %d of %d files succeeded in %.2f s\n", lSucceeded, (int)lJobs.size(), lSeconds);
+    if (lSeconds > 0.0)
+        LOG_INFO("Throughput: %.2f files/s, %.2f MB/s (%.2f MB read)\n", lPending / lSeconds, lMegabytes / lSeconds, lMegabytes);
+    if (pPipelineOptions.mCache)
+        LOG_INFO("Result cache: %d hits, %d misses\n", pPipelineOptions.mCache->GetHits(), pPipelineOptions.mCache->GetMisses());
+    LogAllocationSummary();
+
+    if (!pOptions.mProfileReport.empty())
+    {
+        std::vector<FileProfile> lProfiles;
+        for (size_t i = 0; i < lJobs.size(); ++i)
+        {
+            if (!lJobs[i].mUpToDate)
+                lProfiles.push_back(lJobs[i].mProfile);
+        }
+
+        LogFlush();
+        PrintProfileReport(lProfiles);
+        if (!SaveProfileReport(lProfiles, pOptions.mProfileReport.c_str()))
+            LOG_ERROR("Error: Unable to write profile report %s\n", pOptions.mProfileReport.c_str());
+    }
+
+    return lSucceeded == (int)lJobs.size();
+}
@@ -0,0 +1,31 @@
+#ifndef _BATCH_H
+#define _BATCH_H
+
+#include "Pipeline.h"
+
+struct BatchOptions
+{
+    BatchOptions() : mOutputDirectory("output"), mWorkers(0) {}
+
+    // A directory, a wildcard pattern such as "anims/*.fbx", or "@list.txt" for
+    // a manifest with one input per line and an optional tab separated output.
+    std::string mInput;
+    std::string mOutputDirectory;
+    // Number of worker threads, 0 for one per hardware thread.
+    int mWorkers;
+    // If set, per-file phase timings are printed and written to this JSON file.
+    std::string mProfileReport;
+    // If set, inputs recorded here as unchanged since their last successful run
+    // are skipped, and the file is updated afterwards. See BuildState.
+    std::string mStateFile;
+};
+
+/** Process every input matched by pOptions.mInput with the regular per-file pipeline.
+  * Each worker thread owns its own FbxManager and pulls files from a shared queue.
+  * Prints aggregate throughput when done.
+  * /return true if every file was processed successfully.
+  */
+bool RunBatch(const BatchOptions& pOptions, const PipelineOptions& pPipelineOptions,
+              const JointMap& pJointMap);
+
+#endif // #ifndef _BATCH_H
@@ -0,0 +1,277 @@
+#include "Benchmark.h"
+#include "Common/AnimationUtility.h"
+#include "Common/Common.h"
+#include "Common/FileUtility.h"
+#include "Common/GeometryUtility.h"
+#include "Common/Log.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+// Fixed seed linear congruential generator so every run builds the same scene.
+class BenchmarkRandom
+{
+public:
+    BenchmarkRandom() : mState(12345u) {}
+
+    double Next(double pMin, double pMax)
+    {
+        mState = mState * 1664525u + 1013904223u;
+        return pMin + (pMax - pMin) * ((mState >> 8) / 16777216.0);
+    }
+
+private:
+    unsigned int mState;
+};
+
+bool ParseBenchmarkSpec(const char* pSpec, BenchmarkOptions& pOptions)
+{
+    std::string lSpec = pSpec;
+    size_t lStart = 0;
+    while (lStart < lSpec.size())
+    {
+        size_t lEnd = lSpec.find(',', lStart);
+        if (lEnd == std::string::npos)
+            lEnd = lSpec.size();
+        std::string lItem = lSpec.substr(lStart, lEnd - lStart);
+        lStart = lEnd + 1;
+
+        size_t lEquals = lItem.find('=');
+        std::string lKey = lItem.substr(0, lEquals);
+        int lValue = lEquals == std::string::npos ? 0 : atoi(lItem.c_str() + lEquals + 1);
+
+        int* lTarget = NULL;
+        if (lKey == "joints") lTarget = &pOptions.mJoints;
+        else if (lKey == "depth") lTarget = &pOptions.mDepth;
+        else if (lKey == "stacks") lTarget = &pOptions.mStacks;
+        else if (lKey == "layers") lTarget = &pOptions.mLayers;
+        else if (lKey == "keys") lTarget = &pOptions.mKeys;
+        else if (lKey == "iterations") lTarget = &pOptions.mIterations;
+
+        if (!lTarget || lValue <= 0)
+        {
+            LOG_ERROR("Error: Invalid benchmark setting '%s'\n", lItem.c_str());
+            return false;
+        }
+        *lTarget = lValue;
+    }
+    return true;
+}
+
+static void AnimateProperty(FbxPropertyT<FbxDouble3>& pProperty, FbxAnimLayer* pLayer, int pKeys,
+                            double pMin, double pMax, BenchmarkRandom& pRandom)
+{
+    static const char* const lComponents[3] =
+    {
+        FBXSDK_CURVENODE_COMPONENT_X, FBXSDK_CURVENODE_COMPONENT_Y, FBXSDK_CURVENODE_COMPONENT_Z
+    };
+
+    pProperty.GetCurveNode(pLayer, true);
+    for (int c = 0; c < 3; ++c)
+    {
+        FbxAnimCurve* lCurve = pProperty.GetCurve(pLayer, lComponents[c], true);
+        lCurve->KeyModifyBegin();
+        for (int k = 0; k < pKeys; ++k)
+        {
+            FbxTime lTime;
+            lTime.SetFrame(k, FbxTime::eFrames30);
+            int lIndex = lCurve->KeyAdd(lTime);
+            lCurve->KeySetValue(lIndex, (float)pRandom.Next(pMin, pMax));
+            lCurve->KeySetInterpolation(lIndex, FbxAnimCurveDef::eInterpolationCubic);
+        }
+        lCurve->KeyModifyEnd();
+    }
+}
+
+void CreateBenchmarkScene(FbxScene* pScene, const BenchmarkOptions& pOptions)
+{
+    BenchmarkRandom lRandom;
+    std::vector<FbxNode*> lJoints;
+    char lName[64];
+
+    // Joints hang off the root in chains, so the deepest one has mDepth joints.
+    const int lChainLength = pOptions.mDepth > 1 ? pOptions.mDepth - 1 : 1;
+    for (int i = 0; i < pOptions.mJoints; ++i)
+    {
+        FBXSDK_sprintf(lName, sizeof(lName), "Joint_%d", i);
+        FbxSkeleton* lSkeleton = FbxSkeleton::Create(pScene, lName);
+        lSkeleton->SetSkeletonType(i == 0 ? FbxSkeleton::eRoot : FbxSkeleton::eLimbNode);
+        lSkeleton->Size.Set(1.0);
+
+        FbxNode* lNode = FbxNode::Create(pScene, lName);
+        lNode->SetNodeAttribute(lSkeleton);
+        lNode->LclTranslation.Set(FbxDouble3(lRandom.Next(-10.0, 10.0), lRandom.Next(0.0, 10.0), lRandom.Next(-10.0, 10.0)));
+
+        if (i == 0)
+        {
+            // Exported in inches, like the rigs the root scale fix exists for.
+            lNode->LclScaling.Set(FbxDouble3(2.54, 2.54, 2.54));
+            pScene->GetRootNode()->AddChild(lNode);
+        }
+        else
+        {
+            FbxNode* lParent = pOptions.mDepth > 1 && (i - 1) % lChainLength != 0 ? lJoints[i - 1] : lJoints[0];
+            lParent->AddChild(lNode);
+        }
+        lJoints.push_back(lNode);
+    }
+
+    // Animate every joint on every layer of every stack.
+    for (int s = 0; s < pOptions.mStacks; ++s)
+    {
+        FbxAnimStack* lStack = NULL;
+        FbxAnimLayer* lLayer = CreateDefaultAnimStackAndLayer(pScene, lStack);
+        FBXSDK_sprintf(lName, sizeof(lName), "Stack_%d", s);
+        lStack->SetName(lName);
+
+        FbxTime lStop;
+        lStop.SetFrame(pOptions.mKeys > 1 ? pOptions.mKeys - 1 : 1, FbxTime::eFrames30);
+        lStack->LocalStop.Set(lStop);
+
+        for (int l = 0; l < pOptions.mLayers; ++l)
+        {
+            if (l > 0)
+            {
+                FBXSDK_sprintf(lName, sizeof(lName), "Layer_%d", l);
+                lLayer = FbxAnimLayer::Create(pScene, lName);
+                lStack->AddMember(lLayer);
+            }
+            for (size_t j = 0; j < lJoints.size(); ++j)
+            {
+                AnimateProperty(lJoints[j]->LclTranslation, lLayer, pOptions.mKeys, -10.0, 10.0, lRandom);
+                AnimateProperty(lJoints[j]->LclRotation, lLayer, pOptions.mKeys, -180.0, 180.0, lRandom);
+                AnimateProperty(lJoints[j]->LclScaling, lLayer, pOptions.mKeys, 0.9, 1.1, lRandom);
+            }
+        }
+    }
+
+    // Skin a cube to the skeleton, spreading the control points over the joints.
+    FbxDouble3 lOrigin(0.0, 0.0, 0.0);
+    FbxNode* lMeshNode = CreateCube(pScene, "BenchmarkMesh", lOrigin);
+    pScene->GetRootNode()->AddChild(lMeshNode);
+
+    FbxMesh* lMesh = lMeshNode->GetMesh();
+    FbxSkin* lSkin = FbxSkin::Create(pScene, "BenchmarkSkin");
+    FbxAMatrix lMeshMatrix = lMeshNode->EvaluateGlobalTransform();
+    const int lPointCount = lMesh->GetControlPointsCount();
+    for (size_t j = 0; j < lJoints.size(); ++j)
+    {
+        FbxCluster* lCluster = FbxCluster::Create(pScene, "");
+        lCluster->SetLink(lJoints[j]);
+        lCluster->SetLinkMode(FbxCluster::eTotalOne);
+        lCluster->AddControlPointIndex((int)(j % lPointCount), 1.0);
+        lCluster->SetTransformMatrix(lMeshMatrix);
+        lCluster->SetTransformLinkMatrix(lJoints[j]->EvaluateGlobalTransform());
+        lSkin->AddCluster(lCluster);
+    }
+    lMesh->AddDeformer(lSkin);
+}
+
+static bool WriteBenchmarkJointMap(const char* pFileName, int pJoints)
+{
+    FILE* lFile = fopen(pFileName, "w");
+    if (!lFile)
+        return false;
+    for (int i = 0; i < pJoints; i += 2)
+        fprintf(lFile, "Joint_%d=Renamed_%d\n", i, i);
+    return fclose(lFile) == 0;
+}
+
+bool RunBenchmark(const BenchmarkOptions& pOptions, const PipelineOptions& pPipelineOptions)
+{
+    if (!MakeDirectory(pOptions.mOutputDirectory.c_str()))
+    {
+        LOG_ERROR("Error: Unable to create output directory %s\n", pOptions.mOutputDirectory.c_str());
+        return false;
+    }
+
+    const std::string lInput = JoinPath(pOptions.mOutputDirectory, "benchmark_input.fbx");
+    const std::string lOutput = JoinPath(pOptions.mOutputDirectory, "benchmark_output.fbx");
+    const std::string lMapFile = JoinPath(pOptions.mOutputDirectory, "benchmark_jointmap.cfg");
+
+    JointMap lJointMap;
+    if (!WriteBenchmarkJointMap(lMapFile.c_str(), pOptions.mJoints) || !lJointMap.Load(lMapFile.c_str()))
+    {
+        LOG_ERROR("Error: Unable to write %s\n", lMapFile.c_str());
+        return false;
+    }
+
+    FbxManager* lManager = NULL;
+    FbxScene* lScene = NULL;
+    InitializeSdkObjects(lManager, lScene);
+
+    const long long lKeys = 9LL * pOptions.mJoints * pOptions.mStacks * pOptions.mLayers * pOptions.mKeys;
+    LOG_INFO("Benchmark: %d joints, depth %d, %d stacks x %d layers, %d keys per curve (%lld keys)\n",
+             pOptions.mJoints, pOptions.mDepth, pOptions.mStacks, pOptions.mLayers, pOptions.mKeys, lKeys);
+
+    std::chrono::steady_clock::time_point lStart = std::chrono::steady_clock::now();
+    CreateBenchmarkScene(lScene, pOptions);
+    double lGenerateSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - lStart).count();
+
+    // The input is always binary so the load phase is comparable between runs.
+    bool lResult = SaveScene(lManager, lScene, lInput.c_str());
+    LogFlush();
+    if (!lResult)
+    {
+        DestroySdkObjects(lManager, false);
+        return false;
+    }
+
+    std::vector<FileProfile> lProfiles;
+    for (int i = 0; i < pOptions.mIterations && lResult; ++i)
+    {
+        lScene->Destroy();
+        lScene = FbxScene::Create(lManager, "My Scene");
+
+        FileProfile lProfile;
+        lResult = ProcessFile(lManager, lScene, lInput.c_str(), lOutput.c_str(), pPipelineOptions, lJointMap, &lProfile);
+        lProfiles.push_back(lProfile);
+    }
+    DestroySdkObjects(lManager, false);
+    LogFlush();
+
+    if (!lResult)
+    {
+        LOG_ERROR("Error: Benchmark iteration failed\n");
+        return false;
+    }
+
+    // Report the fastest iteration of each phase; it is the least disturbed by the rest of the machine.
+    double lBest[ePhaseCount];
+    double lBestTotal = lProfiles[0].mTotalSeconds;
+    for (int p = 0; p < ePhaseCount; ++p)
+        lBest[p] = lProfiles[0].mPhaseSeconds[p];
+    for (size_t i = 1; i < lProfiles.size(); ++i)
+    {
+        for (int p = 0; p < ePhaseCount; ++p)
+            if (lProfiles[i].mPhaseSeconds[p] < lBest[p])
+                lBest[p] = lProfiles[i].mPhaseSeconds[p];
+        if (lProfiles[i].mTotalSeconds < lBestTotal)
+            lBestTotal = lProfiles[i].mTotalSeconds;
+    }
+
+    const double lJoints = pOptions.mJoints;
+    const double lKeyCount = (double)(lProfiles[0].mKeys > 0 ? lProfiles[0].mKeys : lKeys);
+    FBXSDK_printf("\nGenerated %d nodes, %d curves, %lld keys in %.3f s (%s, %lld bytes)\n",
+                  lProfiles[0].mNodes, lProfiles[0].mCurves, lProfiles[0].mKeys, lGenerateSeconds,
+                  lInput.c_str(), lProfiles[0].mFileSize);
+    FBXSDK_printf("Best of %d iterations, %s content:\n", (int)lProfiles.size(), lProfiles[0].mContent.c_str());
+    FBXSDK_printf("%14s %12s %14s %12s\n", "phase", "seconds", "us/joint", "ns/key");
+    for (int p = 0; p < ePhaseCount; ++p)
+    {
+        FBXSDK_printf("%14s %12.4f %14.3f %12.3f\n", GetPhaseName((EProfilePhase)p), lBest[p],
+                      lBest[p] * 1e6 / lJoints, lBest[p] * 1e9 / lKeyCount);
+    }
+    FBXSDK_printf("%14s %12.4f %14.3f %12.3f\n", "total", lBestTotal, lBestTotal * 1e6 / lJoints, lBestTotal * 1e9 / lKeyCount);
+    FBXSDK_printf("Peak memory: %.1f MB\n", lProfiles.back().mPeakMemory / (1024.0 * 1024.0));
+
+    if (!pOptions.mProfileReport.empty() && !SaveProfileReport(lProfiles, pOptions.mProfileReport.c_str()))
+    {
+        LOG_ERROR("Error: Unable to write profile report %s\n", pOptions.mProfileReport.c_str());
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,47 @@
+#ifndef _BENCHMARK_H
+#define _BENCHMARK_H
+
+#include "Pipeline.h"
+
+#include <string>
+
+struct BenchmarkOptions
+{
+    BenchmarkOptions()
+        : mJoints(200), mDepth(8), mStacks(1), mLayers(1), mKeys(100), mIterations(3)
+        , mOutputDirectory("benchmark") {}
+
+    int mJoints;
+    // Longest root to leaf chain, root included.
+    int mDepth;
+    int mStacks;
+    // Layers per stack.
+    int mLayers;
+    // Keys per animation curve. Every joint has translation, rotation and scaling curves.
+    int mKeys;
+    int mIterations;
+    std::string mOutputDirectory;
+    // If set, the profile of every iteration is also written to this JSON file.
+    std::string mProfileReport;
+};
+
+/** Parse a comma separated list such as "joints=2000,depth=12,keys=300".
+  * Recognized keys: joints, depth, stacks, layers, keys, iterations.
+  * /return false and print the problem if a key or value is invalid.
+  */
+bool ParseBenchmarkSpec(const char* pSpec, BenchmarkOptions& pOptions);
+
+/** Build a skinned skeleton scene of the given size in pScene. The content only
+  * depends on pOptions, so runs with the same options are comparable.
+  */
+void CreateBenchmarkScene(FbxScene* pScene, const BenchmarkOptions& pOptions);
+
+/** Generate a benchmark scene, save it, then run the regular pipeline on it
+  * pOptions.mIterations times and report per-phase times per joint and per key.
+  * Joint names are renamed through a generated joint map that covers every
+  * other joint.
+  * /return true if every iteration succeeded.
+  */
+bool RunBenchmark(const BenchmarkOptions& pOptions, const PipelineOptions& pPipelineOptions);
+
+#endif // #ifndef _BENCHMARK_H
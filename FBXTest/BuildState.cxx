@@ -0,0 +1,107 @@
+#include "BuildState.h"
+#include "Common/Hash64.h"
+#include "Common/JsonReader.h"
+#include "Common/JsonWriter.h"
+#include "Common/Log.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+
+static bool GetField(const JsonFields& pFields, const char* pName, std::string& pValue)
+{
+    JsonFields::const_iterator it = pFields.find(pName);
+    if (it == pFields.end())
+        return false;
+    pValue = it->second.mText;
+    return true;
+}
+
+bool BuildState::Load(const char* pFileName)
+{
+    mRecords.clear();
+
+    std::ifstream lFile(pFileName);
+    if (!lFile)
+        return true;
+
+    std::string lLine;
+    int lLineNumber = 0;
+    while (std::getline(lFile, lLine))
+    {
+        ++lLineNumber;
+        if (lLine.find_first_not_of(" \t\r") == std::string::npos)
+            continue;
+
+        JsonFields lFields;
+        std::string lError;
+        BuildRecord lRecord;
+        std::string lSize, lModified, lHash, lJointMapHash, lOptionsHash;
+        if (!ParseJsonObject(lLine, lFields, lError) ||
+            !GetField(lFields, "input", lRecord.mInput) || !GetField(lFields, "output", lRecord.mOutput) ||
+            !GetField(lFields, "size", lSize) || !GetField(lFields, "modified", lModified) ||
+            !GetField(lFields, "hash", lHash) || !GetField(lFields, "map", lJointMapHash) ||
+            !GetField(lFields, "options", lOptionsHash))
+        {
+            LOG_ERROR("Error: %s line %d is not a build record\n", pFileName, lLineNumber);
+            mRecords.clear();
+            return false;
+        }
+
+        lRecord.mSize = atoll(lSize.c_str());
+        lRecord.mModified = atoll(lModified.c_str());
+        lRecord.mHash = strtoull(lHash.c_str(), NULL, 16);
+        lRecord.mJointMapHash = strtoull(lJointMapHash.c_str(), NULL, 16);
+        lRecord.mOptionsHash = strtoull(lOptionsHash.c_str(), NULL, 16);
+        mRecords[lRecord.mInput] = lRecord;
+    }
+    return true;
+}
+
+bool BuildState::Save(const char* pFileName) const
+{
+    const std::string lTemporary = std::string(pFileName) + ".tmp";
+    FILE* lFile = fopen(lTemporary.c_str(), "wb");
+    if (!lFile)
+        return false;
+
+    bool lResult = true;
+    JsonWriter lJson;
+    for (std::map<std::string, BuildRecord>::const_iterator it = mRecords.begin(); it != mRecords.end(); ++it)
+    {
+        const BuildRecord& lRecord = it->second;
+        lJson.Clear();
+        lJson.BeginObject();
+        lJson.Key("input");     lJson.String(lRecord.mInput.c_str());
+        lJson.Key("output");    lJson.String(lRecord.mOutput.c_str());
+        lJson.Key("size");      lJson.Int(lRecord.mSize);
+        lJson.Key("modified");  lJson.Int(lRecord.mModified);
+        lJson.Key("hash");      lJson.String(FormatHash64(lRecord.mHash).c_str());
+        lJson.Key("map");       lJson.String(FormatHash64(lRecord.mJointMapHash).c_str());
+        lJson.Key("options");   lJson.String(FormatHash64(lRecord.mOptionsHash).c_str());
+        lJson.EndObject();
+
+        const std::string& lText = lJson.GetText();
+        if (fwrite(lText.c_str(), 1, lText.size(), lFile) != lText.size() || fputc('\n', lFile) == EOF)
+            lResult = false;
+    }
+
+    if (fclose(lFile) != 0)
+        lResult = false;
+
+    // rename() does not replace an existing file on Windows.
+    if (lResult)
+    {
+        remove(pFileName);
+        lResult = rename(lTemporary.c_str(), pFileName) == 0;
+    }
+    if (!lResult)
+        remove(lTemporary.c_str());
+    return lResult;
+}
+
+const BuildRecord* BuildState::Find(const std::string& pInput) const
+{
+    std::map<std::string, BuildRecord>::const_iterator it = mRecords.find(pInput);
+    return it != mRecords.end() ? &it->second : NULL;
+}
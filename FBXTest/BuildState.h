@@ -0,0 +1,48 @@
+#ifndef _BUILD_STATE_H
+#define _BUILD_STATE_H
+
+#include <map>
+#include <string>
+
+/** What an input looked like when it was last processed successfully. */
+struct BuildRecord
+{
+    BuildRecord() : mSize(0), mModified(0), mHash(0), mJointMapHash(0), mOptionsHash(0) {}
+
+    std::string mInput;
+    std::string mOutput;
+    long long mSize;
+    long long mModified;                // Seconds since the epoch.
+    unsigned long long mHash;           // XXH64 of the input bytes.
+    unsigned long long mJointMapHash;   // JointMap::GetContentHash.
+    unsigned long long mOptionsHash;    // Hash of GetOptionsKey.
+};
+
+/** Records of an incremental batch, kept between runs in a JSON lines file with
+  * one flat object per input. Hashes are stored as hex strings, since JSON
+  * numbers cannot hold 64 bits exactly.
+  */
+class BuildState
+{
+public:
+    /** Read a state file. A missing file is an empty state, not an error.
+      * /return false if the file exists but cannot be parsed.
+      */
+    bool Load(const char* pFileName);
+
+    /** Write all records to a temporary file and rename it over pFileName, so an
+      * interrupted run leaves the previous state intact.
+      */
+    bool Save(const char* pFileName) const;
+
+    /** The record of pInput, or NULL if it was never processed. */
+    const BuildRecord* Find(const std::string& pInput) const;
+
+    void Update(const BuildRecord& pRecord) { mRecords[pRecord.mInput] = pRecord; }
+    void Remove(const std::string& pInput) { mRecords.erase(pInput); }
+
+private:
+    std::map<std::string, BuildRecord> mRecords;
+};
+
+#endif // #ifndef _BUILD_STATE_H
@@ -10,22 +10,77 @@
 ****************************************************************************************/
 
 #include "../Common/Common.h"
+#include "FileUtility.h"
+#include "Log.h"
+#include <cstring>
 
 #ifdef IOS_REF
 	#undef  IOS_REF
 	#define IOS_REF (*(pManager->GetIOSettings()))
 #endif
 
+static const char* const gContentProfileNames[] = { "full", "anim", "skeleton" };
+
+const char* GetContentProfileName(EContentProfile pProfile)
+{
+    return gContentProfileNames[pProfile];
+}
+
+bool ParseContentProfile(const char* pName, EContentProfile& pProfile)
+{
+    for (int i = 0; i < (int)(sizeof(gContentProfileNames) / sizeof(gContentProfileNames[0])); ++i)
+    {
+        if (strcmp(pName, gContentProfileNames[i]) == 0)
+        {
+            pProfile = (EContentProfile)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool MatchesAny(const std::vector<std::string>& pPatterns, const char* pName)
+{
+    for (size_t i = 0; i < pPatterns.size(); ++i)
+    {
+        if (WildcardMatch(pPatterns[i].c_str(), pName))
+            return true;
+    }
+    return false;
+}
+
+bool IsTakeSelected(const ImportOptions& pOptions, const char* pName)
+{
+    if (!pOptions.mIncludeTakes.empty() && !MatchesAny(pOptions.mIncludeTakes, pName))
+        return false;
+    return !MatchesAny(pOptions.mExcludeTakes, pName);
+}
+
+void AddTakePatterns(const char* pList, std::vector<std::string>& pPatterns)
+{
+    std::string lList(pList);
+    size_t lStart = 0;
+    while (lStart <= lList.size())
+    {
+        size_t lEnd = lList.find(',', lStart);
+        if (lEnd == std::string::npos)
+            lEnd = lList.size();
+        if (lEnd > lStart)
+            pPatterns.push_back(lList.substr(lStart, lEnd - lStart));
+        lStart = lEnd + 1;
+    }
+}
+
 void InitializeSdkObjects(FbxManager*& pManager, FbxScene*& pScene)
 {
     //The first thing to do is to create the FBX Manager which is the object allocator for almost all the classes in the SDK
     pManager = FbxManager::Create();
     if( !pManager )
     {
-        FBXSDK_printf("Error: Unable to create FBX Manager!\n");
+        LOG_ERROR("Error: Unable to create FBX Manager!\n");
         exit(1);
     }
-	else FBXSDK_printf("Autodesk FBX SDK version %s\n", pManager->GetVersion());
+	else LOG_INFO("Autodesk FBX SDK version %s\n", pManager->GetVersion());
 
 	//Create an IOSettings object. This object holds all import/export settings.
 	FbxIOSettings* ios = FbxIOSettings::Create(pManager, IOSROOT);
@@ -39,7 +94,7 @@ void InitializeSdkObjects(FbxManager*& pManager, FbxScene*& pScene)
     pScene = FbxScene::Create(pManager, "My Scene");
 	if( !pScene )
     {
-        FBXSDK_printf("Error: Unable to create FBX scene!\n");
+        LOG_ERROR("Error: Unable to create FBX scene!\n");
         exit(1);
     }
 }
@@ -48,22 +103,16 @@ void DestroySdkObjects(FbxManager* pManager, bool pExitStatus)
 {
     //Delete the FBX Manager. All the objects that have been allocated using the FBX Manager and that haven't been explicitly destroyed are also automatically destroyed.
     if( pManager ) pManager->Destroy();
-	if( pExitStatus ) FBXSDK_printf("Program Success!\n");
+	if( pExitStatus ) LOG_INFO("Program Success!\n");
 }
 
-bool SaveScene(FbxManager* pManager, FbxDocument* pScene, const char* pFilename, int pFileFormat, bool pEmbedMedia)
+int FindFbxWriterFormat(FbxManager* pManager, ExportOptions::EFormat pFormat)
 {
-    int lMajor, lMinor, lRevision;
-    bool lStatus = true;
+    // The native writer is FBX binary, which is also the fall back if no ASCII writer is found
+    int lFileFormat = pManager->GetIOPluginRegistry()->GetNativeWriterFormat();
 
-    // Create an exporter.
-    FbxExporter* lExporter = FbxExporter::Create(pManager, "");
-
-    if( pFileFormat < 0 || pFileFormat >= pManager->GetIOPluginRegistry()->GetWriterFormatCount() )
+    if (pFormat == ExportOptions::eAscii)
     {
-        // Write in fall back format in less no ASCII format found
-        pFileFormat = pManager->GetIOPluginRegistry()->GetNativeWriterFormat();
-
         //Try to export in ASCII if possible
         int lFormatIndex, lFormatCount = pManager->GetIOPluginRegistry()->GetWriterFormatCount();
 
@@ -75,34 +124,74 @@ bool SaveScene(FbxManager* pManager, FbxDocument* pScene, const char* pFilename,
                 const char *lASCII = "ascii";
                 if (lDesc.Find(lASCII)>=0)
                 {
-                    pFileFormat = lFormatIndex;
+                    lFileFormat = lFormatIndex;
                     break;
                 }
             }
-        } 
+        }
     }
 
+    return lFileFormat;
+}
+
+bool SaveScene(FbxManager* pManager, FbxDocument* pScene, const char* pFilename, const ExportOptions& pOptions)
+{
+    int lMajor, lMinor, lRevision;
+    bool lStatus = true;
+
+    // Create an exporter.
+    FbxExporter* lExporter = FbxExporter::Create(pManager, "");
+
+    int lFileFormat = FindFbxWriterFormat(pManager, pOptions.mFormat);
+
     // Set the export states. By default, the export states are always set to 
     // true except for the option eEXPORT_TEXTURE_AS_EMBEDDED. The code below 
     // shows how to change these states.
-    IOS_REF.SetBoolProp(EXP_FBX_MATERIAL,        true);
-    IOS_REF.SetBoolProp(EXP_FBX_TEXTURE,         true);
-    IOS_REF.SetBoolProp(EXP_FBX_EMBEDDED,        pEmbedMedia);
-    IOS_REF.SetBoolProp(EXP_FBX_SHAPE,           true);
-    IOS_REF.SetBoolProp(EXP_FBX_GOBO,            true);
-    IOS_REF.SetBoolProp(EXP_FBX_ANIMATION,       true);
+    const bool lFull = pOptions.mContent == eContentFull;
+    IOS_REF.SetBoolProp(EXP_FBX_MATERIAL,        lFull);
+    IOS_REF.SetBoolProp(EXP_FBX_TEXTURE,         lFull);
+    IOS_REF.SetBoolProp(EXP_FBX_EMBEDDED,        lFull && pOptions.mEmbedMedia);
+    IOS_REF.SetBoolProp(EXP_FBX_SHAPE,           lFull);
+    IOS_REF.SetBoolProp(EXP_FBX_GOBO,            lFull);
+    IOS_REF.SetBoolProp(EXP_FBX_ANIMATION,       pOptions.mContent != eContentSkeleton);
     IOS_REF.SetBoolProp(EXP_FBX_GLOBAL_SETTINGS, true);
 
+    // Large arrays in binary files are zlib compressed. Level 0 trades file size
+    // for faster writing and reading.
+    if (pOptions.mCompressionLevel >= 0)
+    {
+#ifdef EXP_FBX_COMPRESS_LEVEL
+        IOS_REF.SetIntProp(EXP_FBX_COMPRESS_LEVEL, pOptions.mCompressionLevel);
+#else
+        LOG_WARNING("Array compression level is not supported by this FBX SDK, ignoring it.\n");
+#endif
+    }
+
     // Initialize the exporter by providing a filename.
-    if(lExporter->Initialize(pFilename, pFileFormat, pManager->GetIOSettings()) == false)
+    if(lExporter->Initialize(pFilename, lFileFormat, pManager->GetIOSettings()) == false)
     {
-        FBXSDK_printf("Call to FbxExporter::Initialize() failed.\n");
-        FBXSDK_printf("Error returned: %s\n\n", lExporter->GetStatus().GetErrorString());
+        LOG_ERROR("Call to FbxExporter::Initialize() failed.\n");
+        LOG_ERROR("Error returned: %s\n\n", lExporter->GetStatus().GetErrorString());
+        lExporter->Destroy();
+        return false;
+    }
+
+    if (!pOptions.mVersion.IsEmpty() && !lExporter->SetFileExportVersion(pOptions.mVersion, FbxSceneRenamer::eNone))
+    {
+        LOG_ERROR("FBX file version %s cannot be written. Supported versions:", pOptions.mVersion.Buffer());
+        char const* const* lVersions = lExporter->GetCurrentWritableVersions();
+        for (int i = 0; lVersions && lVersions[i]; i++)
+        {
+            LOG_ERROR(" %s", lVersions[i]);
+        }
+        LOG_ERROR("\n");
+        lExporter->Destroy();
         return false;
     }
 
     FbxManager::GetFileFormatVersion(lMajor, lMinor, lRevision);
-    FBXSDK_printf("FBX file format version %d.%d.%d\n\n", lMajor, lMinor, lRevision);
+    LOG_INFO("FBX file format version %d.%d.%d, %s\n\n", lMajor, lMinor, lRevision,
+                  pManager->GetIOPluginRegistry()->GetWriterFormatDescription(lFileFormat));
 
     // Export the scene.
     lStatus = lExporter->Export(pScene); 
@@ -112,7 +201,7 @@ bool SaveScene(FbxManager* pManager, FbxDocument* pScene, const char* pFilename,
     return lStatus;
 }
 
-bool LoadScene(FbxManager* pManager, FbxDocument* pScene, const char* pFilename)
+bool LoadScene(FbxManager* pManager, FbxDocument* pScene, const char* pFilename, const ImportOptions& pOptions)
 {
     int lFileMajor, lFileMinor, lFileRevision;
     int lSDKMajor,  lSDKMinor,  lSDKRevision;
@@ -134,69 +223,88 @@ bool LoadScene(FbxManager* pManager, FbxDocument* pScene, const char* pFilename)
     if( !lImportStatus )
     {
         FbxString error = lImporter->GetStatus().GetErrorString();
-        FBXSDK_printf("Call to FbxImporter::Initialize() failed.\n");
-        FBXSDK_printf("Error returned: %s\n\n", error.Buffer());
+        LOG_ERROR("Call to FbxImporter::Initialize() failed.\n");
+        LOG_ERROR("Error returned: %s\n\n", error.Buffer());
 
         if (lImporter->GetStatus().GetCode() == FbxStatus::eInvalidFileVersion)
         {
-            FBXSDK_printf("FBX file format version for this FBX SDK is %d.%d.%d\n", lSDKMajor, lSDKMinor, lSDKRevision);
-            FBXSDK_printf("FBX file format version for file '%s' is %d.%d.%d\n\n", pFilename, lFileMajor, lFileMinor, lFileRevision);
+            LOG_ERROR("FBX file format version for this FBX SDK is %d.%d.%d\n", lSDKMajor, lSDKMinor, lSDKRevision);
+            LOG_ERROR("FBX file format version for file '%s' is %d.%d.%d\n\n", pFilename, lFileMajor, lFileMinor, lFileRevision);
         }
 
         return false;
     }
 
-    FBXSDK_printf("FBX file format version for this FBX SDK is %d.%d.%d\n", lSDKMajor, lSDKMinor, lSDKRevision);
+    LOG_INFO("FBX file format version for this FBX SDK is %d.%d.%d\n", lSDKMajor, lSDKMinor, lSDKRevision);
 
     if (lImporter->IsFBX())
     {
-        FBXSDK_printf("FBX file format version for file '%s' is %d.%d.%d\n\n", pFilename, lFileMajor, lFileMinor, lFileRevision);
+        const bool lAnimation = pOptions.mContent != eContentSkeleton && !pOptions.mSkipAnimation;
+        int lSelectedCount = 0;
+
+        LOG_INFO("FBX file format version for file '%s' is %d.%d.%d\n\n", pFilename, lFileMajor, lFileMinor, lFileRevision);
 
         // From this point, it is possible to access animation stack information without
         // the expense of loading the entire file.
 
-        FBXSDK_printf("Animation Stack Information\n");
+        LOG_TRACE("Animation Stack Information\n");
 
         lAnimStackCount = lImporter->GetAnimStackCount();
 
-        FBXSDK_printf("    Number of Animation Stacks: %d\n", lAnimStackCount);
-        FBXSDK_printf("    Current Animation Stack: \"%s\"\n", lImporter->GetActiveAnimStackName().Buffer());
-        FBXSDK_printf("\n");
+        LOG_TRACE("    Number of Animation Stacks: %d\n", lAnimStackCount);
+        LOG_TRACE("    Current Animation Stack: \"%s\"\n", lImporter->GetActiveAnimStackName().Buffer());
+        LOG_TRACE("\n");
 
         for(i = 0; i < lAnimStackCount; i++)
         {
             FbxTakeInfo* lTakeInfo = lImporter->GetTakeInfo(i);
 
-            FBXSDK_printf("    Animation Stack %d\n", i);
-            FBXSDK_printf("         Name: \"%s\"\n", lTakeInfo->mName.Buffer());
-            FBXSDK_printf("         Description: \"%s\"\n", lTakeInfo->mDescription.Buffer());
+            LOG_TRACE("    Animation Stack %d\n", i);
+            LOG_TRACE("         Name: \"%s\"\n", lTakeInfo->mName.Buffer());
+            LOG_TRACE("         Description: \"%s\"\n", lTakeInfo->mDescription.Buffer());
 
             // Change the value of the import name if the animation stack should be imported 
             // under a different name.
-            FBXSDK_printf("         Import Name: \"%s\"\n", lTakeInfo->mImportName.Buffer());
+            LOG_TRACE("         Import Name: \"%s\"\n", lTakeInfo->mImportName.Buffer());
 
             // Set the value of the import state to false if the animation stack should be not
             // be imported. 
-            FBXSDK_printf("         Import State: %s\n", lTakeInfo->mSelect ? "true" : "false");
-            FBXSDK_printf("\n");
+            if (!lAnimation || !IsTakeSelected(pOptions, lTakeInfo->mName.Buffer()))
+                lTakeInfo->mSelect = false;
+            if (lTakeInfo->mSelect)
+                ++lSelectedCount;
+            LOG_TRACE("         Import State: %s\n", lTakeInfo->mSelect ? "true" : "false");
+            LOG_TRACE("\n");
         }
 
         // Set the import states. By default, the import states are always set to 
-        // true. The code below shows how to change these states.
-        IOS_REF.SetBoolProp(IMP_FBX_MATERIAL,        true);
-        IOS_REF.SetBoolProp(IMP_FBX_TEXTURE,         true);
-        IOS_REF.SetBoolProp(IMP_FBX_LINK,            true);
-        IOS_REF.SetBoolProp(IMP_FBX_SHAPE,           true);
-        IOS_REF.SetBoolProp(IMP_FBX_GOBO,            true);
-        IOS_REF.SetBoolProp(IMP_FBX_ANIMATION,       true);
+        // true. Reduced content profiles turn off what the job never uses, so the
+        // importer does not parse or allocate it.
+        if (lSelectedCount < lAnimStackCount)
+            LOG_INFO("Importing %d of %d animation stacks\n\n", lSelectedCount, lAnimStackCount);
+        if (lAnimation && lSelectedCount == 0 && !pOptions.mIncludeTakes.empty())
+            LOG_WARNING("Warning: no take of %s matches the take patterns\n", pFilename);
+
+        const bool lFull = pOptions.mContent == eContentFull;
+        IOS_REF.SetBoolProp(IMP_FBX_MATERIAL,        lFull);
+        IOS_REF.SetBoolProp(IMP_FBX_TEXTURE,         lFull);
+        IOS_REF.SetBoolProp(IMP_FBX_LINK,            lFull);
+        IOS_REF.SetBoolProp(IMP_FBX_SHAPE,           lFull);
+        IOS_REF.SetBoolProp(IMP_FBX_GOBO,            lFull);
+        IOS_REF.SetBoolProp(IMP_FBX_ANIMATION,       lAnimation);
         IOS_REF.SetBoolProp(IMP_FBX_GLOBAL_SETTINGS, true);
     }
 
     // Import the scene.
     lStatus = lImporter->Import(pScene);
 
-    if(lStatus == false && lImporter->GetStatus().GetCode() == FbxStatus::ePasswordError)
+    if (lStatus == false && lImporter->GetStatus().GetCode() == FbxStatus::ePasswordError && !pOptions.mPromptPassword)
+    {
+        LOG_ERROR("%s is password protected, import aborted.\n", pFilename);
+    }
+    else if(lStatus == false && lImporter->GetStatus().GetCode() == FbxStatus::ePasswordError)
     {
+        LogFlush();
         FBXSDK_printf("Please enter password: ");
 
         lPassword[0] = '\0';
@@ -214,7 +322,7 @@ bool LoadScene(FbxManager* pManager, FbxDocument* pScene, const char* pFilename)
 
         if(lStatus == false && lImporter->GetStatus().GetCode() == FbxStatus::ePasswordError)
         {
-            FBXSDK_printf("\nPassword is wrong, import aborted.\n");
+            LOG_ERROR("\nPassword is wrong, import aborted.\n");
         }
     }
 
@@ -12,13 +12,76 @@
 #define _COMMON_H
 
 #include <fbxsdk.h>
+#include <string>
+#include <vector>
+
+/** What the importer materializes and the exporter writes. Smaller profiles skip
+  * parsing and allocating data that a job never touches.
+  */
+enum EContentProfile
+{
+    eContentFull,       // Everything, the default.
+    eContentAnimation,  // Nodes, skeletons and animation; no materials, textures, shapes, gobos or skin links.
+    eContentSkeleton    // Like eContentAnimation, without the animation.
+};
+
+const char* GetContentProfileName(EContentProfile pProfile);
+
+/** Parse "full", "anim" or "skeleton". Returns false for anything else. */
+bool ParseContentProfile(const char* pName, EContentProfile& pProfile);
+
+struct ImportOptions
+{
+    ImportOptions() : mContent(eContentFull), mSkipAnimation(false), mPromptPassword(true) {}
+
+    EContentProfile mContent;
+    // Deselect every take, so no animation is read even if mContent includes it.
+    bool mSkipAnimation;
+    // Ask for the password of a protected file on the console. When false such a
+    // file just fails to load, for runs whose stdin and stdout carry other data or
+    // that load from several threads at once.
+    bool mPromptPassword;
+    // Wildcard patterns for take names, matched ignoring case. With include patterns
+    // only matching takes are imported; a take matching an exclude pattern never is.
+    std::vector<std::string> mIncludeTakes;
+    std::vector<std::string> mExcludeTakes;
+};
+
+/** Whether pOptions lets the take named pName be imported. */
+bool IsTakeSelected(const ImportOptions& pOptions, const char* pName);
+
+/** Append the patterns of a comma separated list such as "Walk*,Run*" to pPatterns. */
+void AddTakePatterns(const char* pList, std::vector<std::string>& pPatterns);
+
+struct ExportOptions
+{
+    enum EFormat
+    {
+        eBinary,
+        eAscii
+    };
+
+    ExportOptions() : mFormat(eBinary), mCompressionLevel(-1), mEmbedMedia(false), mContent(eContentFull) {}
+
+    EFormat mFormat;
+    // FBX file version to write, e.g. FBX_2014_00_COMPATIBLE ("FBX201400"). Empty for the SDK default.
+    FbxString mVersion;
+    // Array compression level for binary output, 0 (off) to 9. -1 keeps the SDK default.
+    int mCompressionLevel;
+    bool mEmbedMedia;
+    EContentProfile mContent;
+};
 
 void InitializeSdkObjects(FbxManager*& pManager, FbxScene*& pScene);
 void DestroySdkObjects(FbxManager* pManager, bool pExitStatus);
 void CreateAndFillIOSettings(FbxManager* pManager);
 
-bool SaveScene(FbxManager* pManager, FbxDocument* pScene, const char* pFilename, int pFileFormat=-1, bool pEmbedMedia=false);
-bool LoadScene(FbxManager* pManager, FbxDocument* pScene, const char* pFilename);
+int FindFbxWriterFormat(FbxManager* pManager, ExportOptions::EFormat pFormat);
+bool SaveScene(FbxManager* pManager, FbxDocument* pScene, const char* pFilename, const ExportOptions& pOptions=ExportOptions());
+/** Import an FBX file into pScene. Takes that pOptions does not select are
+  * deselected before the import, so their curves are never read.
+  */
+bool LoadScene(FbxManager* pManager, FbxDocument* pScene, const char* pFilename, const ImportOptions& pOptions=ImportOptions());
 
 #endif // #ifndef _COMMON_H
 
@@ -0,0 +1,215 @@
+#include "FileUtility.h"
+
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+
+#if defined(_WIN32)
+    #include <windows.h>
+    #include <direct.h>
+    #include <sys/types.h>
+    #include <sys/stat.h>
+#else
+    #include <dirent.h>
+    #include <errno.h>
+    #include <sys/types.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+bool IsDirectory(const char* pPath)
+{
+#if defined(_WIN32)
+    DWORD lAttributes = GetFileAttributesA(pPath);
+    return lAttributes != INVALID_FILE_ATTRIBUTES && (lAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+#else
+    struct stat lStat;
+    return stat(pPath, &lStat) == 0 && S_ISDIR(lStat.st_mode);
+#endif
+}
+
+bool MakeDirectory(const char* pPath)
+{
+    if (IsDirectory(pPath))
+        return true;
+#if defined(_WIN32)
+    return _mkdir(pPath) == 0;
+#else
+    return mkdir(pPath, 0755) == 0 || errno == EEXIST;
+#endif
+}
+
+bool ListDirectory(const char* pDirectory, std::vector<std::string>& pFiles)
+{
+#if defined(_WIN32)
+    WIN32_FIND_DATAA lFindData;
+    HANDLE lFind = FindFirstFileA(JoinPath(pDirectory, "*").c_str(), &lFindData);
+    if (lFind == INVALID_HANDLE_VALUE)
+        return false;
+
+    do
+    {
+        if ((lFindData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == 0)
+            pFiles.push_back(JoinPath(pDirectory, lFindData.cFileName));
+    } while (FindNextFileA(lFind, &lFindData));
+
+    FindClose(lFind);
+    return true;
+#else
+    DIR* lDir = opendir(pDirectory);
+    if (!lDir)
+        return false;
+
+    while (struct dirent* lEntry = readdir(lDir))
+    {
+        std::string lPath = JoinPath(pDirectory, lEntry->d_name);
+        struct stat lStat;
+        if (stat(lPath.c_str(), &lStat) == 0 && S_ISREG(lStat.st_mode))
+            pFiles.push_back(lPath);
+    }
+
+    closedir(lDir);
+    return true;
+#endif
+}
+
+bool WildcardMatch(const char* pPattern, const char* pName)
+{
+    // Iterative matcher: on mismatch, backtrack to the last '*' and let it
+    // swallow one more character.
+    const char* lStar = NULL;
+    const char* lResume = NULL;
+
+    while (*pName)
+    {
+        if (*pPattern == '*')
+        {
+            lStar = pPattern++;
+            lResume = pName;
+        }
+        else if (*pPattern == '?' || tolower((unsigned char)*pPattern) == tolower((unsigned char)*pName))
+        {
+            ++pPattern;
+            ++pName;
+        }
+        else if (lStar)
+        {
+            pPattern = lStar + 1;
+            pName = ++lResume;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    while (*pPattern == '*')
+        ++pPattern;
+
+    return *pPattern == '\0';
+}
+
+bool HasWildcard(const char* pPattern)
+{
+    return strpbrk(pPattern, "*?") != NULL;
+}
+
+long long GetFileSize(const char* pPath)
+{
+#if defined(_WIN32)
+    struct _stat64 lStat;
+    if (_stat64(pPath, &lStat) != 0)
+        return -1;
+#else
+    struct stat lStat;
+    if (stat(pPath, &lStat) != 0)
+        return -1;
+#endif
+    return (long long)lStat.st_size;
+}
+
+long long GetFileModificationTime(const char* pPath)
+{
+#if defined(_WIN32)
+    struct _stat64 lStat;
+    if (_stat64(pPath, &lStat) != 0)
+        return -1;
+#else
+    struct stat lStat;
+    if (stat(pPath, &lStat) != 0)
+        return -1;
+#endif
+    return (long long)lStat.st_mtime;
+}
+
+void SplitPath(const std::string& pPath, std::string& pDirectory, std::string& pFileName)
+{
+    size_t lSeparator = pPath.find_last_of("/\\");
+    if (lSeparator == std::string::npos)
+    {
+        pDirectory = ".";
+        pFileName = pPath;
+    }
+    else
+    {
+        pDirectory = pPath.substr(0, lSeparator);
+        pFileName = pPath.substr(lSeparator + 1);
+        if (pDirectory.empty())
+            pDirectory = "/";
+    }
+}
+
+std::string JoinPath(const std::string& pDirectory, const std::string& pFileName)
+{
+    if (pDirectory.empty())
+        return pFileName;
+
+    char lLast = pDirectory[pDirectory.size() - 1];
+    if (lLast == '/' || lLast == '\\')
+        return pDirectory + pFileName;
+
+    return pDirectory + "/" + pFileName;
+}
+
+bool CopyFileContents(const char* pSource, const char* pDestination)
+{
+    FILE* lSource = fopen(pSource, "rb");
+    if (!lSource)
+        return false;
+    FILE* lDestination = fopen(pDestination, "wb");
+    if (!lDestination)
+    {
+        fclose(lSource);
+        return false;
+    }
+
+    static const size_t BUFFER_SIZE = 1 << 20;
+    std::vector<char> lBuffer(BUFFER_SIZE);
+    bool lResult = true;
+    size_t lRead;
+    while ((lRead = fread(&lBuffer[0], 1, BUFFER_SIZE, lSource)) > 0)
+    {
+        if (fwrite(&lBuffer[0], 1, lRead, lDestination) != lRead)
+        {
+            lResult = false;
+            break;
+        }
+    }
+    if (ferror(lSource))
+        lResult = false;
+
+    fclose(lSource);
+    if (fclose(lDestination) != 0)
+        lResult = false;
+    return lResult;
+}
+
+bool MakeHardLink(const char* pTarget, const char* pLink)
+{
+    remove(pLink);
+#if defined(_WIN32)
+    return CreateHardLinkA(pLink, pTarget, NULL) != 0;
+#else
+    return link(pTarget, pLink) == 0;
+#endif
+}
@@ -0,0 +1,59 @@
+#ifndef INCLUDE_FILE_UTILITY_H_
+#define INCLUDE_FILE_UTILITY_H_
+
+#include <string>
+#include <vector>
+
+/** Check whether a path names an existing directory.
+  * /param pPath The path to check.
+  * /return true if pPath is a directory.
+  */
+bool IsDirectory(const char* pPath);
+
+/** Create a directory. An already existing directory is not an error.
+  * /param pPath The directory to create. Parent directories must exist.
+  * /return true if the directory exists after the call.
+  */
+bool MakeDirectory(const char* pPath);
+
+/** List the regular files of a directory (not recursive).
+  * /param pDirectory The directory to list.
+  * /param pFiles Receives the full paths of the files found.
+  * /return false if the directory could not be opened.
+  */
+bool ListDirectory(const char* pDirectory, std::vector<std::string>& pFiles);
+
+/** Match a file name against a pattern with '*' and '?' wildcards, ignoring case.
+  * /param pPattern The wildcard pattern.
+  * /param pName The name to test.
+  * /return true if pName matches pPattern.
+  */
+bool WildcardMatch(const char* pPattern, const char* pName);
+
+/** Check whether a string contains '*' or '?' wildcards. */
+bool HasWildcard(const char* pPattern);
+
+/** Size of a file in bytes, or -1 if it cannot be accessed. */
+long long GetFileSize(const char* pPath);
+
+/** Last modification time of a file in seconds since the epoch, or -1 if it cannot be accessed. */
+long long GetFileModificationTime(const char* pPath);
+
+/** Copy a file, replacing pDestination if it exists.
+  * /return false if the source cannot be read or the destination written.
+  */
+bool CopyFileContents(const char* pSource, const char* pDestination);
+
+/** Make pLink a hard link to pTarget, replacing pLink if it exists. Both must be
+  * on the same volume.
+  * /return false if the link could not be created.
+  */
+bool MakeHardLink(const char* pTarget, const char* pLink);
+
+/** Split a path into its directory ("." if none) and file name parts. */
+void SplitPath(const std::string& pPath, std::string& pDirectory, std::string& pFileName);
+
+/** Join a directory and a file name with a path separator. */
+std::string JoinPath(const std::string& pDirectory, const std::string& pFileName);
+
+#endif // INCLUDE_FILE_UTILITY_H_
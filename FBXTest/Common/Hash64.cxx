@@ -0,0 +1,124 @@
+#include "Hash64.h"
+#include "../Native/MappedFile.h"
+
+#include <cstdio>
+#include <cstring>
+
+static const unsigned long long PRIME1 = 11400714785074694791ULL;
+static const unsigned long long PRIME2 = 14029467366897019727ULL;
+static const unsigned long long PRIME3 = 1609587929392839161ULL;
+static const unsigned long long PRIME4 = 9650029242287828579ULL;
+static const unsigned long long PRIME5 = 2870177450012600261ULL;
+
+static inline unsigned long long Rotate(unsigned long long pValue, int pBits)
+{
+    return (pValue << pBits) | (pValue >> (64 - pBits));
+}
+
+// Unaligned little endian reads; memcpy compiles to a single load.
+static inline unsigned long long Read64(const unsigned char* pData)
+{
+    unsigned long long lValue;
+    memcpy(&lValue, pData, sizeof(lValue));
+    return lValue;
+}
+
+static inline unsigned int Read32(const unsigned char* pData)
+{
+    unsigned int lValue;
+    memcpy(&lValue, pData, sizeof(lValue));
+    return lValue;
+}
+
+static inline unsigned long long Round(unsigned long long pAccumulator, unsigned long long pInput)
+{
+    pAccumulator += pInput * PRIME2;
+    pAccumulator = Rotate(pAccumulator, 31);
+    return pAccumulator * PRIME1;
+}
+
+static inline unsigned long long MergeRound(unsigned long long pHash, unsigned long long pAccumulator)
+{
+    pHash ^= Round(0, pAccumulator);
+    return pHash * PRIME1 + PRIME4;
+}
+
+unsigned long long Hash64(const void* pData, size_t pLength, unsigned long long pSeed)
+{
+    const unsigned char* lData = (const unsigned char*)pData;
+    const unsigned char* const lEnd = lData + pLength;
+    unsigned long long lHash;
+
+    if (pLength >= 32)
+    {
+        // Four independent lanes keep the multipliers busy.
+        const unsigned char* const lLimit = lEnd - 32;
+        unsigned long long v1 = pSeed + PRIME1 + PRIME2;
+        unsigned long long v2 = pSeed + PRIME2;
+        unsigned long long v3 = pSeed;
+        unsigned long long v4 = pSeed - PRIME1;
+        do
+        {
+            v1 = Round(v1, Read64(lData));
+            v2 = Round(v2, Read64(lData + 8));
+            v3 = Round(v3, Read64(lData + 16));
+            v4 = Round(v4, Read64(lData + 24));
+            lData += 32;
+        }
+        while (lData <= lLimit);
+
+        lHash = Rotate(v1, 1) + Rotate(v2, 7) + Rotate(v3, 12) + Rotate(v4, 18);
+        lHash = MergeRound(lHash, v1);
+        lHash = MergeRound(lHash, v2);
+        lHash = MergeRound(lHash, v3);
+        lHash = MergeRound(lHash, v4);
+    }
+    else
+    {
+        lHash = pSeed + PRIME5;
+    }
+
+    lHash += (unsigned long long)pLength;
+
+    for (; lData + 8 <= lEnd; lData += 8)
+    {
+        lHash ^= Round(0, Read64(lData));
+        lHash = Rotate(lHash, 27) * PRIME1 + PRIME4;
+    }
+    if (lData + 4 <= lEnd)
+    {
+        lHash ^= (unsigned long long)Read32(lData) * PRIME1;
+        lHash = Rotate(lHash, 23) * PRIME2 + PRIME3;
+        lData += 4;
+    }
+    for (; lData < lEnd; ++lData)
+    {
+        lHash ^= (*lData) * PRIME5;
+        lHash = Rotate(lHash, 11) * PRIME1;
+    }
+
+    lHash ^= lHash >> 33;
+    lHash *= PRIME2;
+    lHash ^= lHash >> 29;
+    lHash *= PRIME3;
+    lHash ^= lHash >> 32;
+    return lHash;
+}
+
+std::string FormatHash64(unsigned long long pHash)
+{
+    char lBuffer[17];
+    sprintf(lBuffer, "%016llx", pHash);
+    return lBuffer;
+}
+
+bool HashFile(const char* pFileName, unsigned long long& pHash, long long* pSize)
+{
+    MappedFile lFile;
+    if (!lFile.Open(pFileName))
+        return false;
+    pHash = Hash64(lFile.GetData(), lFile.GetSize());
+    if (pSize)
+        *pSize = (long long)lFile.GetSize();
+    return true;
+}
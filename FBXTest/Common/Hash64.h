@@ -0,0 +1,27 @@
+#ifndef _HASH64_H
+#define _HASH64_H
+
+#include <stddef.h>
+#include <string>
+
+/** 64 bit XXH64 hash of a memory block. Fast enough to fingerprint whole input
+  * files (several GB/s); not meant for security.
+  */
+unsigned long long Hash64(const void* pData, size_t pLength, unsigned long long pSeed = 0);
+
+/** Hash a string's bytes. */
+inline unsigned long long Hash64(const std::string& pText, unsigned long long pSeed = 0)
+{
+    return Hash64(pText.data(), pText.size(), pSeed);
+}
+
+/** XXH64 of a whole file's bytes, read through a memory mapping.
+  * /param pSize If not NULL, receives the file size.
+  * /return false if the file cannot be read.
+  */
+bool HashFile(const char* pFileName, unsigned long long& pHash, long long* pSize = NULL);
+
+/** Sixteen lower case hex digits. */
+std::string FormatHash64(unsigned long long pHash);
+
+#endif // #ifndef _HASH64_H
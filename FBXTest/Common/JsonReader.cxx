@@ -0,0 +1,247 @@
+#include "JsonReader.h"
+
+#include <cstring>
+
+namespace
+{
+    class Parser
+    {
+    public:
+        Parser(const std::string& pText) : mText(pText), mPos(0) {}
+
+        void SkipSpace()
+        {
+            // strchr also finds the terminator, so a NUL byte must be excluded first.
+            while (mPos < mText.size() && mText[mPos] != '\0' && strchr(" \t\r\n", mText[mPos]))
+                ++mPos;
+        }
+
+        bool Accept(char pChar)
+        {
+            SkipSpace();
+            if (mPos < mText.size() && mText[mPos] == pChar)
+            {
+                ++mPos;
+                return true;
+            }
+            return false;
+        }
+
+        bool AtEnd()
+        {
+            SkipSpace();
+            return mPos == mText.size();
+        }
+
+        bool String(std::string& pValue)
+        {
+            if (!Accept('"'))
+                return false;
+            pValue.clear();
+            while (mPos < mText.size())
+            {
+                char lChar = mText[mPos++];
+                if (lChar == '"')
+                    return true;
+                if ((unsigned char)lChar < 0x20)
+                    return false;
+                if (lChar != '\\')
+                {
+                    pValue += lChar;
+                    continue;
+                }
+                if (mPos >= mText.size())
+                    return false;
+                switch (mText[mPos++])
+                {
+                case '"':  pValue += '"'; break;
+                case '\\': pValue += '\\'; break;
+                case '/':  pValue += '/'; break;
+                case 'b':  pValue += '\b'; break;
+                case 'f':  pValue += '\f'; break;
+                case 'n':  pValue += '\n'; break;
+                case 'r':  pValue += '\r'; break;
+                case 't':  pValue += '\t'; break;
+                case 'u':
+                    if (!Unicode(pValue))
+                        return false;
+                    break;
+                default:
+                    return false;
+                }
+            }
+            return false;
+        }
+
+        bool Literal(std::string& pValue)
+        {
+            SkipSpace();
+            size_t lStart = mPos;
+            while (mPos < mText.size() && mText[mPos] != '\0' && strchr("+-.0123456789eEtrufalsn", mText[mPos]))
+                ++mPos;
+            pValue = mText.substr(lStart, mPos - lStart);
+            return pValue == "true" || pValue == "false" || pValue == "null" || IsNumber(pValue);
+        }
+
+    private:
+        // The JSON number grammar: -?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)?
+        // strtod alone would also take "nan", "inf" and hex numbers.
+        static bool IsNumber(const std::string& pText)
+        {
+            const char* lChar = pText.c_str();
+            if (*lChar == '-')
+                ++lChar;
+            if (*lChar == '0')
+                ++lChar;
+            else if (!SkipDigits(lChar))
+                return false;
+            if (*lChar == '.')
+            {
+                ++lChar;
+                if (!SkipDigits(lChar))
+                    return false;
+            }
+            if (*lChar == 'e' || *lChar == 'E')
+            {
+                ++lChar;
+                if (*lChar == '+' || *lChar == '-')
+                    ++lChar;
+                if (!SkipDigits(lChar))
+                    return false;
+            }
+            return *lChar == '\0';
+        }
+
+        static bool SkipDigits(const char*& pChar)
+        {
+            const char* lStart = pChar;
+            while (*pChar >= '0' && *pChar <= '9')
+                ++pChar;
+            return pChar != lStart;
+        }
+
+        // \uXXXX to UTF-8. Paths are the only strings that need it, and surrogate
+        // pairs are combined so names outside the BMP survive.
+        bool Unicode(std::string& pValue)
+        {
+            unsigned long lCode;
+            if (!Hex4(lCode))
+                return false;
+            // A low surrogate must follow a high one; alone it is not a character.
+            if (lCode >= 0xDC00 && lCode < 0xE000)
+                return false;
+            if (lCode >= 0xD800 && lCode < 0xDC00)
+            {
+                unsigned long lLow;
+                if (mText.compare(mPos, 2, "\\u") != 0)
+                    return false;
+                mPos += 2;
+                if (!Hex4(lLow) || lLow < 0xDC00 || lLow >= 0xE000)
+                    return false;
+                lCode = 0x10000 + ((lCode - 0xD800) << 10) + (lLow - 0xDC00);
+            }
+
+            if (lCode < 0x80)
+                pValue += (char)lCode;
+            else if (lCode < 0x800)
+            {
+                pValue += (char)(0xC0 | (lCode >> 6));
+                pValue += (char)(0x80 | (lCode & 0x3F));
+            }
+            else if (lCode < 0x10000)
+            {
+                pValue += (char)(0xE0 | (lCode >> 12));
+                pValue += (char)(0x80 | ((lCode >> 6) & 0x3F));
+                pValue += (char)(0x80 | (lCode & 0x3F));
+            }
+            else
+            {
+                pValue += (char)(0xF0 | (lCode >> 18));
+                pValue += (char)(0x80 | ((lCode >> 12) & 0x3F));
+                pValue += (char)(0x80 | ((lCode >> 6) & 0x3F));
+                pValue += (char)(0x80 | (lCode & 0x3F));
+            }
+            return true;
+        }
+
+        bool Hex4(unsigned long& pCode)
+        {
+            if (mPos + 4 > mText.size())
+                return false;
+            // strtoul would also accept signs, spaces and a "0x" prefix.
+            pCode = 0;
+            for (int i = 0; i < 4; ++i)
+            {
+                char lChar = mText[mPos++];
+                unsigned long lDigit;
+                if (lChar >= '0' && lChar <= '9')
+                    lDigit = lChar - '0';
+                else if (lChar >= 'a' && lChar <= 'f')
+                    lDigit = lChar - 'a' + 10;
+                else if (lChar >= 'A' && lChar <= 'F')
+                    lDigit = lChar - 'A' + 10;
+                else
+                    return false;
+                pCode = (pCode << 4) | lDigit;
+            }
+            return true;
+        }
+
+        const std::string& mText;
+        size_t mPos;
+    };
+}
+
+bool ParseJsonObject(const std::string& pText, JsonFields& pFields, std::string& pError)
+{
+    pFields.clear();
+    Parser lParser(pText);
+
+    if (!lParser.Accept('{'))
+    {
+        pError = "expected an object";
+        return false;
+    }
+
+    if (!lParser.Accept('}'))
+    {
+        do
+        {
+            std::string lKey;
+            if (!lParser.String(lKey) || !lParser.Accept(':'))
+            {
+                pError = "expected a member name";
+                return false;
+            }
+
+            JsonScalar lValue;
+            lParser.SkipSpace();
+            if (lParser.Accept('{') || lParser.Accept('['))
+            {
+                pError = "nested value for " + lKey;
+                return false;
+            }
+            lValue.mIsString = lParser.String(lValue.mText);
+            if (!lValue.mIsString && !lParser.Literal(lValue.mText))
+            {
+                pError = "bad value for " + lKey;
+                return false;
+            }
+            pFields[lKey] = lValue;
+        }
+        while (lParser.Accept(','));
+
+        if (!lParser.Accept('}'))
+        {
+            pError = "expected , or }";
+            return false;
+        }
+    }
+
+    if (!lParser.AtEnd())
+    {
+        pError = "trailing characters";
+        return false;
+    }
+    return true;
+}
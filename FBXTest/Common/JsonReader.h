@@ -0,0 +1,32 @@
+#ifndef _JSON_READER_H
+#define _JSON_READER_H
+
+#include <map>
+#include <string>
+
+/** One member of a flat JSON object. Strings are unescaped; numbers, true,
+  * false and null keep their literal text.
+  */
+struct JsonScalar
+{
+    JsonScalar() : mIsString(false) {}
+
+    std::string mText;
+    bool mIsString;
+
+    bool IsTrue() const { return !mIsString && mText == "true"; }
+};
+
+typedef std::map<std::string, JsonScalar> JsonFields;
+
+/** Parse a JSON object whose members are all strings, numbers, booleans or null,
+  * such as one line of a JSON lines request stream. Nested objects and arrays
+  * are rejected; nothing here needs them.
+  * /param pText The text to parse; surrounding white space is allowed.
+  * /param pFields Receives the members. A repeated key keeps its last value.
+  * /param pError Receives a short description when parsing fails.
+  * /return false if pText is not such an object.
+  */
+bool ParseJsonObject(const std::string& pText, JsonFields& pFields, std::string& pError);
+
+#endif // #ifndef _JSON_READER_H
@@ -0,0 +1,172 @@
+#include "JsonWriter.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+JsonWriter::JsonWriter()
+    : mAfterKey(false)
+{
+}
+
+void JsonWriter::Clear()
+{
+    mText.clear();
+    mHasItems.clear();
+    mAfterKey = false;
+}
+
+void JsonWriter::BeforeValue()
+{
+    if (mAfterKey)
+    {
+        mAfterKey = false;
+        return;
+    }
+    if (!mHasItems.empty())
+    {
+        if (mHasItems.back())
+            mText += ',';
+        mHasItems.back() = true;
+    }
+}
+
+void JsonWriter::BeginObject()
+{
+    BeforeValue();
+    mText += '{';
+    mHasItems.push_back(false);
+}
+
+void JsonWriter::EndObject()
+{
+    mHasItems.pop_back();
+    mText += '}';
+}
+
+void JsonWriter::BeginArray()
+{
+    BeforeValue();
+    mText += '[';
+    mHasItems.push_back(false);
+}
+
+void JsonWriter::EndArray()
+{
+    mHasItems.pop_back();
+    mText += ']';
+}
+
+void JsonWriter::Key(const char* pName)
+{
+    BeforeValue();
+    mText += '"';
+    AppendEscaped(pName, strlen(pName));
+    mText += "\":";
+    mAfterKey = true;
+}
+
+void JsonWriter::String(const char* pValue)
+{
+    String(pValue, strlen(pValue));
+}
+
+void JsonWriter::String(const char* pValue, size_t pLength)
+{
+    BeforeValue();
+    mText += '"';
+    AppendEscaped(pValue, pLength);
+    mText += '"';
+}
+
+void JsonWriter::Int(long long pValue)
+{
+    BeforeValue();
+    char lBuffer[32];
+    sprintf(lBuffer, "%lld", pValue);
+    mText += lBuffer;
+}
+
+void JsonWriter::Double(double pValue)
+{
+    BeforeValue();
+    // JSON has no representation for NaN or infinity.
+    if (pValue != pValue || pValue == HUGE_VAL || pValue == -HUGE_VAL)
+    {
+        mText += "null";
+        return;
+    }
+    char lBuffer[32];
+    sprintf(lBuffer, "%.9g", pValue);
+    mText += lBuffer;
+}
+
+void JsonWriter::Bool(bool pValue)
+{
+    BeforeValue();
+    mText += pValue ? "true" : "false";
+}
+
+void JsonWriter::Null()
+{
+    BeforeValue();
+    mText += "null";
+}
+
+void JsonWriter::Raw(const char* pText, size_t pLength)
+{
+    BeforeValue();
+    mText.append(pText, pLength);
+}
+
+void JsonWriter::Members(const char* pObject, size_t pLength)
+{
+    // Skip the braces; an empty object adds nothing.
+    if (pLength <= 2)
+        return;
+    BeforeValue();
+    mText.append(pObject + 1, pLength - 2);
+}
+
+void JsonWriter::NewLine()
+{
+    mText += '\n';
+}
+
+void JsonWriter::AppendEscaped(const char* pValue, size_t pLength)
+{
+    for (size_t i = 0; i < pLength; ++i)
+    {
+        unsigned char c = (unsigned char)pValue[i];
+        switch (c)
+        {
+        case '"':  mText += "\\\""; break;
+        case '\\': mText += "\\\\"; break;
+        case '\n': mText += "\\n"; break;
+        case '\r': mText += "\\r"; break;
+        case '\t': mText += "\\t"; break;
+        default:
+            if (c < 0x20)
+            {
+                char lBuffer[8];
+                sprintf(lBuffer, "\\u%04x", c);
+                mText += lBuffer;
+            }
+            else
+            {
+                mText += (char)c;
+            }
+            break;
+        }
+    }
+}
+
+bool JsonWriter::Save(const char* pFileName) const
+{
+    FILE* lFile = fopen(pFileName, "wb");
+    if (!lFile)
+        return false;
+    bool lResult = fwrite(mText.data(), 1, mText.size(), lFile) == mText.size();
+    lResult = fputc('\n', lFile) != EOF && lResult;
+    return fclose(lFile) == 0 && lResult;
+}
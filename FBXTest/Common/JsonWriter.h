@@ -0,0 +1,64 @@
+#ifndef _JSON_WRITER_H
+#define _JSON_WRITER_H
+
+#include <string>
+#include <vector>
+
+/** Minimal JSON builder for machine readable reports.
+  *
+  * Values are appended to one in-memory string; commas and key quoting are
+  * handled from a small nesting stack, so callers only describe structure.
+  * Numbers are formatted on the stack, so once the string has grown, writing
+  * a value allocates nothing:
+  *
+  *     JsonWriter lJson;
+  *     lJson.BeginObject();
+  *     lJson.Key("files"); lJson.Int(3);
+  *     lJson.EndObject();
+  */
+class JsonWriter
+{
+public:
+    JsonWriter();
+
+    void BeginObject();
+    void EndObject();
+    void BeginArray();
+    void EndArray();
+
+    /** Name the next value. Only valid directly inside an object. */
+    void Key(const char* pName);
+
+    void String(const char* pValue);
+    void String(const char* pValue, size_t pLength);
+    void Int(long long pValue);
+    void Double(double pValue);
+    void Bool(bool pValue);
+    void Null();
+
+    /** Append an already formatted value, such as the text of another writer. */
+    void Raw(const char* pText, size_t pLength);
+    /** Append the members of an already formatted object to the object being written. */
+    void Members(const char* pObject, size_t pLength);
+
+    /** Separate top level values with a newline, for JSON lines (NDJSON) output. */
+    void NewLine();
+
+    void Reserve(size_t pBytes) { mText.reserve(pBytes); }
+
+    const std::string& GetText() const { return mText; }
+    void Clear();
+
+    /** Write the text to a file. Returns false if it cannot be written. */
+    bool Save(const char* pFileName) const;
+
+private:
+    void BeforeValue();
+    void AppendEscaped(const char* pValue, size_t pLength);
+
+    std::string mText;
+    std::vector<bool> mHasItems;    // One entry per open object/array.
+    bool mAfterKey;
+};
+
+#endif // #ifndef _JSON_WRITER_H
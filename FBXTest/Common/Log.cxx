@@ -0,0 +1,147 @@
+#include "Log.h"
+#include "ThreadLocal.h"
+
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+
+static const size_t LOG_BUFFER_SIZE = 256 * 1024;
+
+int gLogLevel = eLogInfo;
+
+// One buffer per thread so batch workers never contend while formatting; the
+// mutex only orders whole blocks written to the log stream.
+static THREAD_LOCAL char* gBuffer = NULL;
+static THREAD_LOCAL size_t gUsed = 0;
+static std::mutex gOutputMutex;
+static FILE* gStream = NULL;    // NULL for stdout, which is not a constant.
+
+static void WriteOut(const char* pText, size_t pLength)
+{
+    if (pLength == 0)
+        return;
+    std::lock_guard<std::mutex> lLock(gOutputMutex);
+    FILE* lStream = gStream ? gStream : stdout;
+    fwrite(pText, 1, pLength, lStream);
+    fflush(lStream);
+}
+
+void SetLogLevel(ELogLevel pLevel)
+{
+    gLogLevel = pLevel;
+}
+
+void SetLogStream(FILE* pStream)
+{
+    gStream = pStream;
+}
+
+bool ParseLogLevel(const char* pName, ELogLevel& pLevel)
+{
+    static const char* const lNames[] = { "silent", "error", "warning", "info", "trace" };
+    for (int i = 0; i < (int)(sizeof(lNames) / sizeof(lNames[0])); ++i)
+    {
+        if (strcmp(pName, lNames[i]) == 0)
+        {
+            pLevel = (ELogLevel)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+void LogAppend(const char* pText, size_t pLength)
+{
+    if (!gBuffer)
+        gBuffer = (char*)malloc(LOG_BUFFER_SIZE);
+    if (!gBuffer || pLength > LOG_BUFFER_SIZE)
+    {
+        LogFlush();
+        WriteOut(pText, pLength);
+        return;
+    }
+    if (gUsed + pLength > LOG_BUFFER_SIZE)
+        LogFlush();
+    memcpy(gBuffer + gUsed, pText, pLength);
+    gUsed += pLength;
+}
+
+void LogWrite(ELogLevel pLevel, const char* pFormat, ...)
+{
+    if (!gBuffer)
+        gBuffer = (char*)malloc(LOG_BUFFER_SIZE);
+
+    va_list lArgs;
+    va_start(lArgs, pFormat);
+
+    // Format straight into the free space. MSVC's vsnprintf returns -1 instead of
+    // the required length on truncation, so treat both as "did not fit".
+    bool lDone = false;
+    for (int lAttempt = 0; gBuffer && lAttempt < 2 && !lDone; ++lAttempt)
+    {
+        size_t lFree = LOG_BUFFER_SIZE - gUsed;
+        va_list lCopy;
+        va_copy(lCopy, lArgs);
+        int lLength = vsnprintf(gBuffer + gUsed, lFree, pFormat, lCopy);
+        va_end(lCopy);
+
+        if (lLength >= 0 && (size_t)lLength < lFree)
+        {
+            gUsed += lLength;
+            lDone = true;
+        }
+        else if (gUsed > 0)
+        {
+            LogFlush();
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    if (!lDone)
+    {
+        // Longer than the whole buffer: format on the heap and write it through.
+        size_t lSize = LOG_BUFFER_SIZE * 2;
+        for (;;)
+        {
+            char* lText = (char*)malloc(lSize);
+            if (!lText)
+                break;
+            va_list lCopy;
+            va_copy(lCopy, lArgs);
+            int lLength = vsnprintf(lText, lSize, pFormat, lCopy);
+            va_end(lCopy);
+            if (lLength >= 0 && (size_t)lLength < lSize)
+            {
+                LogFlush();
+                WriteOut(lText, lLength);
+                free(lText);
+                break;
+            }
+            free(lText);
+            lSize = lLength >= 0 ? lLength + 1 : lSize * 2;
+        }
+    }
+    va_end(lArgs);
+
+    if (pLevel <= eLogError)
+        LogFlush();
+}
+
+void LogFlush()
+{
+    if (gBuffer)
+        WriteOut(gBuffer, gUsed);
+    gUsed = 0;
+}
+
+void LogReleaseThread()
+{
+    LogFlush();
+    free(gBuffer);
+    gBuffer = NULL;
+}
@@ -0,0 +1,56 @@
+#ifndef _LOG_H
+#define _LOG_H
+
+#include <stddef.h>
+#include <stdio.h>
+
+enum ELogLevel
+{
+    eLogSilent,
+    eLogError,
+    eLogWarning,
+    eLogInfo,
+    eLogTrace
+};
+
+// Read without locking on every log call, so only change it before worker threads start.
+extern int gLogLevel;
+
+void SetLogLevel(ELogLevel pLevel);
+
+/** Parse "silent", "error", "warning", "info" or "trace". Returns false for anything else. */
+bool ParseLogLevel(const char* pName, ELogLevel& pLevel);
+
+/** Send log output to pStream instead of stdout, e.g. when stdout carries a protocol.
+  * Like the level, only change it before worker threads start.
+  */
+void SetLogStream(FILE* pStream);
+
+inline bool LogEnabled(ELogLevel pLevel) { return gLogLevel >= (int)pLevel; }
+
+/** Format a message into the calling thread's log buffer. Errors flush immediately.
+  * Prefer the LOG_* macros, which skip argument evaluation and formatting when the
+  * level is disabled.
+  */
+void LogWrite(ELogLevel pLevel, const char* pFormat, ...)
+#if defined(__GNUC__)
+    __attribute__((format(printf, 2, 3)))
+#endif
+    ;
+
+/** Append raw text to the calling thread's log buffer. */
+void LogAppend(const char* pText, size_t pLength);
+
+/** Write the calling thread's buffer to the log stream in one block. Call at phase boundaries. */
+void LogFlush();
+
+/** Flush and free the calling thread's buffer. Worker threads call this before they exit. */
+void LogReleaseThread();
+
+#define FBXTEST_LOG(level, ...) do { if (LogEnabled(level)) LogWrite(level, __VA_ARGS__); } while (0)
+#define LOG_ERROR(...)   FBXTEST_LOG(eLogError, __VA_ARGS__)
+#define LOG_WARNING(...) FBXTEST_LOG(eLogWarning, __VA_ARGS__)
+#define LOG_INFO(...)    FBXTEST_LOG(eLogInfo, __VA_ARGS__)
+#define LOG_TRACE(...)   FBXTEST_LOG(eLogTrace, __VA_ARGS__)
+
+#endif // #ifndef _LOG_H
@@ -0,0 +1,56 @@
+#include "ParallelFor.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+int ResolveThreadCount(int pRequested)
+{
+    int lThreads = pRequested;
+    if (lThreads <= 0)
+        lThreads = (int)std::thread::hardware_concurrency();
+    return lThreads > 0 ? lThreads : 1;
+}
+
+static void RunChunks(size_t pCount, size_t pGrain, std::atomic<size_t>& pNext,
+                      const std::function<void(size_t, size_t)>& pBody)
+{
+    for (size_t lBegin = pNext.fetch_add(pGrain); lBegin < pCount; lBegin = pNext.fetch_add(pGrain))
+    {
+        size_t lEnd = lBegin + pGrain < pCount ? lBegin + pGrain : pCount;
+        pBody(lBegin, lEnd);
+    }
+}
+
+void ParallelFor(size_t pCount, size_t pGrain, int pThreads,
+                 const std::function<void(size_t, size_t)>& pBody)
+{
+    if (pCount == 0)
+        return;
+    if (pGrain == 0)
+        pGrain = 1;
+
+    size_t lChunks = (pCount + pGrain - 1) / pGrain;
+    size_t lThreads = (size_t)ResolveThreadCount(pThreads);
+    if (lThreads > lChunks)
+        lThreads = lChunks;
+
+    if (lThreads <= 1)
+    {
+        pBody(0, pCount);
+        return;
+    }
+
+    std::atomic<size_t> lNext(0);
+    std::vector<std::thread> lWorkers;
+    for (size_t i = 1; i < lThreads; ++i)
+    {
+        lWorkers.push_back(std::thread(RunChunks, pCount, pGrain, std::ref(lNext), std::cref(pBody)));
+    }
+    RunChunks(pCount, pGrain, lNext, pBody);
+
+    for (size_t i = 0; i < lWorkers.size(); ++i)
+    {
+        lWorkers[i].join();
+    }
+}
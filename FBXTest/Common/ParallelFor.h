@@ -0,0 +1,20 @@
+#ifndef _PARALLEL_FOR_H
+#define _PARALLEL_FOR_H
+
+#include <stddef.h>
+#include <functional>
+
+/** Number of worker threads to use for a requested count: 0 means one per
+  * hardware thread, and the result is always at least 1.
+  */
+int ResolveThreadCount(int pRequested);
+
+/** Call pBody(begin, end) over [0, pCount) split into chunks of at most pGrain
+  * items, using up to pThreads threads including the calling one. Chunks are
+  * handed out dynamically, so uneven work balances itself. Returns once every
+  * chunk is done. With one thread, or a single chunk, everything runs inline.
+  */
+void ParallelFor(size_t pCount, size_t pGrain, int pThreads,
+                 const std::function<void(size_t, size_t)>& pBody);
+
+#endif // #ifndef _PARALLEL_FOR_H
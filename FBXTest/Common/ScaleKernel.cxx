@@ -0,0 +1,193 @@
+#include "ScaleKernel.h"
+
+#include <cstring>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+    #define SCALE_KERNEL_X86 1
+    #include <immintrin.h>
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+        // MSVC compiles AVX intrinsics without a per-function target.
+        #define SCALE_KERNEL_AVX_TARGET
+    #else
+        #include <cpuid.h>
+        #define SCALE_KERNEL_AVX_TARGET __attribute__((target("avx")))
+    #endif
+#endif
+
+enum EScaleKernel
+{
+    eKernelScalar,
+    eKernelSSE2,
+    eKernelAVX
+};
+
+static void ScaleScalar(unsigned char* pData, size_t pCount, float pFactor)
+{
+    for (size_t i = 0; i < pCount; ++i)
+    {
+        float lValue;
+        memcpy(&lValue, pData + i * 4, 4);
+        lValue *= pFactor;
+        memcpy(pData + i * 4, &lValue, 4);
+    }
+}
+
+static void ScaleSlopesScalar(unsigned char* pData, size_t pAttributeCount, float pFactor)
+{
+    for (size_t i = 0; i < pAttributeCount; ++i)
+    {
+        ScaleScalar(pData + i * 16, 2, pFactor);
+    }
+}
+
+#if defined(SCALE_KERNEL_X86)
+
+static EScaleKernel DetectKernel()
+{
+    int lInfo[4] = { 0, 0, 0, 0 };
+#if defined(_MSC_VER)
+    __cpuid(lInfo, 1);
+#else
+    unsigned int a, b, c, d;
+    if (!__get_cpuid(1, &a, &b, &c, &d))
+        return eKernelScalar;
+    lInfo[0] = (int)a; lInfo[1] = (int)b; lInfo[2] = (int)c; lInfo[3] = (int)d;
+#endif
+    const bool lSSE2 = (lInfo[3] & (1 << 26)) != 0;
+    const bool lOSXSave = (lInfo[2] & (1 << 27)) != 0;
+    const bool lAVX = (lInfo[2] & (1 << 28)) != 0;
+
+    // AVX also needs the OS to save the YMM registers on context switches.
+    if (lAVX && lOSXSave)
+    {
+#if defined(_MSC_VER)
+        unsigned long long lXCR0 = _xgetbv(0);
+#else
+        unsigned int lLow, lHigh;
+        __asm__ ("xgetbv" : "=a"(lLow), "=d"(lHigh) : "c"(0));
+        unsigned long long lXCR0 = ((unsigned long long)lHigh << 32) | lLow;
+#endif
+        if ((lXCR0 & 6) == 6)
+            return eKernelAVX;
+    }
+    return lSSE2 ? eKernelSSE2 : eKernelScalar;
+}
+
+static void ScaleSSE2(unsigned char* pData, size_t pCount, float pFactor)
+{
+    const __m128 lFactor = _mm_set1_ps(pFactor);
+    size_t i = 0;
+    for (; i + 4 <= pCount; i += 4)
+    {
+        float* lPointer = (float*)(pData + i * 4);
+        _mm_storeu_ps(lPointer, _mm_mul_ps(_mm_loadu_ps(lPointer), lFactor));
+    }
+    ScaleScalar(pData + i * 4, pCount - i, pFactor);
+}
+
+static void ScaleSlopesSSE2(unsigned char* pData, size_t pAttributeCount, float pFactor)
+{
+    // Select the scaled lanes 0 and 1 and the original bits of lanes 2 and 3, so
+    // packed weights are never touched by float arithmetic (denormal flushing).
+    const __m128 lFactor = _mm_set1_ps(pFactor);
+    const __m128 lMask = _mm_castsi128_ps(_mm_set_epi32(0, 0, -1, -1));
+    for (size_t i = 0; i < pAttributeCount; ++i)
+    {
+        float* lPointer = (float*)(pData + i * 16);
+        __m128 lValue = _mm_loadu_ps(lPointer);
+        __m128 lScaled = _mm_mul_ps(lValue, lFactor);
+        _mm_storeu_ps(lPointer, _mm_or_ps(_mm_and_ps(lMask, lScaled), _mm_andnot_ps(lMask, lValue)));
+    }
+}
+
+SCALE_KERNEL_AVX_TARGET
+static void ScaleAVX(unsigned char* pData, size_t pCount, float pFactor)
+{
+    const __m256 lFactor = _mm256_set1_ps(pFactor);
+    size_t i = 0;
+    for (; i + 16 <= pCount; i += 16)
+    {
+        float* lPointer = (float*)(pData + i * 4);
+        __m256 lValue0 = _mm256_loadu_ps(lPointer);
+        __m256 lValue1 = _mm256_loadu_ps(lPointer + 8);
+        _mm256_storeu_ps(lPointer, _mm256_mul_ps(lValue0, lFactor));
+        _mm256_storeu_ps(lPointer + 8, _mm256_mul_ps(lValue1, lFactor));
+    }
+    for (; i + 8 <= pCount; i += 8)
+    {
+        float* lPointer = (float*)(pData + i * 4);
+        _mm256_storeu_ps(lPointer, _mm256_mul_ps(_mm256_loadu_ps(lPointer), lFactor));
+    }
+    _mm256_zeroupper();
+    ScaleSSE2(pData + i * 4, pCount - i, pFactor);
+}
+
+SCALE_KERNEL_AVX_TARGET
+static void ScaleSlopesAVX(unsigned char* pData, size_t pAttributeCount, float pFactor)
+{
+    // Two attributes per register; blend keeps the original lanes 2, 3, 6 and 7.
+    const __m256 lFactor = _mm256_set1_ps(pFactor);
+    size_t i = 0;
+    for (; i + 2 <= pAttributeCount; i += 2)
+    {
+        float* lPointer = (float*)(pData + i * 16);
+        __m256 lValue = _mm256_loadu_ps(lPointer);
+        _mm256_storeu_ps(lPointer, _mm256_blend_ps(lValue, _mm256_mul_ps(lValue, lFactor), 0x33));
+    }
+    _mm256_zeroupper();
+    ScaleSlopesSSE2(pData + i * 16, pAttributeCount - i, pFactor);
+}
+
+#else
+
+static EScaleKernel DetectKernel()
+{
+    return eKernelScalar;
+}
+
+#endif // SCALE_KERNEL_X86
+
+static EScaleKernel GetKernel()
+{
+    // Detected once. VS2013 does not guard local statics, but a racing first
+    // call can at worst see eKernelScalar, which is always valid.
+    static const EScaleKernel sKernel = DetectKernel();
+    return sKernel;
+}
+
+void ScaleFloatArray(unsigned char* pData, size_t pCount, float pFactor)
+{
+#if defined(SCALE_KERNEL_X86)
+    switch (GetKernel())
+    {
+    case eKernelAVX:  ScaleAVX(pData, pCount, pFactor); return;
+    case eKernelSSE2: ScaleSSE2(pData, pCount, pFactor); return;
+    default: break;
+    }
+#endif
+    ScaleScalar(pData, pCount, pFactor);
+}
+
+void ScaleKeyAttributeSlopes(unsigned char* pData, size_t pAttributeCount, float pFactor)
+{
+#if defined(SCALE_KERNEL_X86)
+    switch (GetKernel())
+    {
+    case eKernelAVX:  ScaleSlopesAVX(pData, pAttributeCount, pFactor); return;
+    case eKernelSSE2: ScaleSlopesSSE2(pData, pAttributeCount, pFactor); return;
+    default: break;
+    }
+#endif
+    ScaleSlopesScalar(pData, pAttributeCount, pFactor);
+}
+
+const char* GetScaleKernelName()
+{
+    switch (GetKernel())
+    {
+    case eKernelAVX:  return "avx";
+    case eKernelSSE2: return "sse2";
+    default:          return "scalar";
+    }
+}
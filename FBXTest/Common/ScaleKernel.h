@@ -0,0 +1,22 @@
+#ifndef _SCALE_KERNEL_H
+#define _SCALE_KERNEL_H
+
+#include <stddef.h>
+
+/** Multiply pCount little endian floats stored at pData by pFactor, in place.
+  * pData needs no particular alignment, so it can point straight into a mapped
+  * FBX file. Uses AVX or SSE2 when the CPU has them, scalar code otherwise.
+  */
+void ScaleFloatArray(unsigned char* pData, size_t pCount, float pFactor);
+
+/** Scale the tangents of pAttributeCount FBX key attributes in place.
+  * Each attribute is four floats: right slope, next left slope, and the packed
+  * weights and velocities. Only the two slopes are multiplied; the packed
+  * words are left bit for bit untouched.
+  */
+void ScaleKeyAttributeSlopes(unsigned char* pData, size_t pAttributeCount, float pFactor);
+
+/** Name of the instruction set the kernels use on this machine: "avx", "sse2" or "scalar". */
+const char* GetScaleKernelName();
+
+#endif // #ifndef _SCALE_KERNEL_H
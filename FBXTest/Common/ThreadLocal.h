@@ -0,0 +1,12 @@
+#ifndef _THREAD_LOCAL_H
+#define _THREAD_LOCAL_H
+
+// VS2013 has no thread_local; __declspec(thread) works for plain data, so
+// only use this for variables without constructors or destructors.
+#if defined(_MSC_VER) && _MSC_VER < 1900
+    #define THREAD_LOCAL __declspec(thread)
+#else
+    #define THREAD_LOCAL thread_local
+#endif
+
+#endif // #ifndef _THREAD_LOCAL_H
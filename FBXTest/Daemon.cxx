@@ -0,0 +1,235 @@
+#include "Daemon.h"
+#include "Common/Common.h"
+#include "Common/JsonReader.h"
+#include "Common/JsonWriter.h"
+#include "Common/Log.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+
+static void WriteResponse(const JsonWriter& pJson)
+{
+    fwrite(pJson.GetText().c_str(), 1, pJson.GetText().size(), stdout);
+    fputc('\n', stdout);
+    fflush(stdout);
+}
+
+static void WriteId(JsonWriter& pJson, const JsonFields& pRequest)
+{
+    JsonFields::const_iterator it = pRequest.find("id");
+    if (it == pRequest.end())
+        return;
+
+    pJson.Key("id");
+    if (it->second.mIsString)
+        pJson.String(it->second.mText.c_str());
+    else if (it->second.mText == "null")
+        pJson.Null();
+    else if (it->second.mText == "true" || it->second.mText == "false")
+        pJson.Bool(it->second.IsTrue());
+    else if (it->second.mText.find_first_of(".eE") == std::string::npos)
+        pJson.Int(atoll(it->second.mText.c_str()));
+    else
+        pJson.Double(atof(it->second.mText.c_str()));
+}
+
+static void WriteError(const JsonFields& pRequest, const std::string& pError)
+{
+    JsonWriter lJson;
+    lJson.BeginObject();
+    WriteId(lJson, pRequest);
+    lJson.Key("success"); lJson.Bool(false);
+    lJson.Key("error");   lJson.String(pError.c_str());
+    lJson.EndObject();
+    WriteResponse(lJson);
+}
+
+/** Apply the members of a request to a copy of the default options. */
+static bool GetJobOptions(const JsonFields& pRequest, PipelineOptions& pOptions, std::string& pError)
+{
+    for (JsonFields::const_iterator it = pRequest.begin(); it != pRequest.end(); ++it)
+    {
+        const std::string& lKey = it->first;
+        const JsonScalar& lValue = it->second;
+
+        if (lKey == "removeanim")        pOptions.mRemoveAnim = lValue.IsTrue();
+        else if (lKey == "nativerename") pOptions.mNativeRename = lValue.IsTrue();
+        else if (lKey == "animscale")    pOptions.mAnimatedScale = lValue.IsTrue();
+        else if (lKey == "scalethreads") pOptions.mScaleThreads = atoi(lValue.mText.c_str());
+        else if (lKey == "nativescale")  pOptions.mNativeScale = atof(lValue.mText.c_str());
+        else if (lKey == "fuseunits")    pOptions.mFuseUnits = lValue.IsTrue();
+        else if (lKey == "bake")         pOptions.mBakeRate = atof(lValue.mText.c_str());
+        else if (lKey == "reducekeys")   pOptions.mKeyTolerance = atof(lValue.mText.c_str());
+        else if (lKey == "fbxversion")   pOptions.mExport.mVersion = lValue.mText.c_str();
+        else if (lKey == "compress")     pOptions.mExport.mCompressionLevel = atoi(lValue.mText.c_str());
+        else if (lKey == "takes" || lKey == "excludetakes")
+        {
+            // A job's patterns replace the defaults rather than adding to them.
+            std::vector<std::string>& lPatterns = lKey == "takes" ? pOptions.mIncludeTakes : pOptions.mExcludeTakes;
+            lPatterns.clear();
+            AddTakePatterns(lValue.mText.c_str(), lPatterns);
+        }
+        else if (lKey == "content")
+        {
+            if (!ParseContentProfile(lValue.mText.c_str(), pOptions.mContent))
+            {
+                pError = "unknown content profile " + lValue.mText;
+                return false;
+            }
+        }
+        else if (lKey == "format")
+        {
+            if (lValue.mText == "ascii")       pOptions.mExport.mFormat = ExportOptions::eAscii;
+            else if (lValue.mText == "binary") pOptions.mExport.mFormat = ExportOptions::eBinary;
+            else
+            {
+                pError = "unknown format " + lValue.mText;
+                return false;
+            }
+        }
+        else if (lKey != "id" && lKey != "command" && lKey != "input" && lKey != "output" && lKey != "map")
+        {
+            pError = "unknown member " + lKey;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool RunDaemon(const PipelineOptions& pDefaults, const std::string& pDefaultMap)
+{
+    // stdout carries the responses from here on.
+    SetLogStream(stderr);
+
+    FbxManager* lManager = NULL;
+    FbxScene* lScene = NULL;
+    std::map<std::string, JointMap> lJointMaps;
+
+    // Pay for the SDK start-up now rather than on the first request.
+    if (!pDefaults.mNativeRename)
+        InitializeSdkObjects(lManager, lScene);
+    LogFlush();
+
+    {
+        JsonWriter lJson;
+        lJson.BeginObject();
+        lJson.Key("ready"); lJson.Bool(true);
+        lJson.EndObject();
+        WriteResponse(lJson);
+    }
+
+    std::string lLine;
+    while (std::getline(std::cin, lLine))
+    {
+        if (lLine.find_first_not_of(" \t\r") == std::string::npos)
+            continue;
+
+        JsonFields lRequest;
+        std::string lError;
+        if (!ParseJsonObject(lLine, lRequest, lError))
+        {
+            WriteError(lRequest, "bad request: " + lError);
+            continue;
+        }
+
+        const std::string lCommand = lRequest.count("command") ? lRequest["command"].mText : std::string("process");
+        if (lCommand == "quit")
+            break;
+        if (lCommand == "reload")
+        {
+            lJointMaps.clear();
+            JsonWriter lJson;
+            lJson.BeginObject();
+            WriteId(lJson, lRequest);
+            lJson.Key("success"); lJson.Bool(true);
+            lJson.EndObject();
+            WriteResponse(lJson);
+            continue;
+        }
+        if (lCommand != "process")
+        {
+            WriteError(lRequest, "unknown command " + lCommand);
+            continue;
+        }
+
+        // A password prompt would write into the response stream and read the next request.
+        PipelineOptions lOptions = pDefaults;
+        lOptions.mPromptPassword = false;
+        if (!GetJobOptions(lRequest, lOptions, lError))
+        {
+            WriteError(lRequest, lError);
+            continue;
+        }
+        if (!lRequest.count("input") || !lRequest.count("output"))
+        {
+            WriteError(lRequest, "input and output are required");
+            continue;
+        }
+
+        // Joint maps are loaded once per path and kept for later jobs.
+        const std::string lMapPath = lRequest.count("map") ? lRequest["map"].mText : pDefaultMap;
+        std::map<std::string, JointMap>::iterator lMap = lJointMaps.find(lMapPath);
+        if (lMap == lJointMaps.end())
+        {
+            JointMap lJointMap;
+            if (!lJointMap.Load(lMapPath.c_str()))
+            {
+                WriteError(lRequest, "unable to open joint map " + lMapPath);
+                continue;
+            }
+            lMap = lJointMaps.insert(std::make_pair(lMapPath, lJointMap)).first;
+        }
+
+        if (!lOptions.mNativeRename && !lManager)
+            InitializeSdkObjects(lManager, lScene);
+
+        FileProfile lProfile;
+        BeginAllocationArena();
+        bool lResult = ProcessFile(lOptions.mNativeRename ? NULL : lManager, lOptions.mNativeRename ? NULL : lScene,
+                                   lRequest["input"].mText.c_str(), lRequest["output"].mText.c_str(),
+                                   lOptions, lMap->second, &lProfile);
+        LogFlush();
+
+        // Start the next job from a clean scene; the manager stays alive.
+        if (!lOptions.mNativeRename)
+        {
+            lScene->Destroy();
+            EndAllocationArena();
+            lScene = FbxScene::Create(lManager, "My Scene");
+        }
+        else
+        {
+            EndAllocationArena();
+        }
+
+        JsonWriter lJson;
+        lJson.BeginObject();
+        WriteId(lJson, lRequest);
+        lJson.Key("success"); lJson.Bool(lResult);
+        if (!lResult)
+        {
+            lJson.Key("error"); lJson.String("processing failed, see log");
+        }
+        lJson.Key("content"); lJson.String(lProfile.mContent.c_str());
+        lJson.Key("cached");  lJson.Bool(lProfile.mCacheHit);
+        lJson.Key("seconds"); lJson.Double(lProfile.mTotalSeconds);
+        lJson.Key("phases");
+        lJson.BeginObject();
+        for (int p = 0; p < ePhaseCount; ++p)
+        {
+            lJson.Key(GetPhaseName((EProfilePhase)p));
+            lJson.Double(lProfile.mPhaseSeconds[p]);
+        }
+        lJson.EndObject();
+        lJson.EndObject();
+        WriteResponse(lJson);
+    }
+
+    if (lManager)
+        DestroySdkObjects(lManager, false);
+    LogAllocationSummary();
+    LogFlush();
+    return true;
+}
@@ -0,0 +1,34 @@
+#ifndef _DAEMON_H
+#define _DAEMON_H
+
+#include "Pipeline.h"
+
+#include <string>
+
+/** Serve pipeline jobs read from stdin as JSON lines until "quit" or end of input.
+  *
+  * The FBX manager and every joint map that was used are kept between jobs, so a
+  * job only pays for its own load, processing and save. Each request is one line:
+  *
+  *     {"id": 7, "input": "a.fbx", "output": "out/a.fbx", "map": "jointmap.cfg", "removeanim": true}
+  *
+  * Optional members override pDefaults for that job: "map", "removeanim",
+  * "nativerename", "animscale", "scalethreads", "nativescale", "bake", "reducekeys",
+  * "fuseunits", "content" ("full", "anim" or "skeleton"), "takes" and
+  * "excludetakes" (comma separated patterns), "format" ("binary" or "ascii"),
+  * "fbxversion" and "compress".
+  * {"command": "reload"} forgets the cached joint maps and {"command": "quit"}
+  * stops the loop.
+  *
+  * Every request gets one JSON line on stdout with the echoed "id", "success",
+  * an "error" message on failure, whether the result came from the result
+  * cache, and the total and per-phase seconds. Log output goes to stderr while
+  * the daemon runs. Jobs run one at a time in the order received.
+  *
+  * /param pDefaults Options for members a request leaves out.
+  * /param pDefaultMap Joint map file for requests without "map".
+  * /return true if the loop ended normally.
+  */
+bool RunDaemon(const PipelineOptions& pDefaults, const std::string& pDefaultMap);
+
+#endif // #ifndef _DAEMON_H
@@ -10,6 +10,7 @@
 ****************************************************************************************/
 
 #include "DisplayCommon.h"
+#include "Common/Log.h"
 #if defined (FBXSDK_ENV_MAC)
 // disable the format not a string literal and no format arguments warning since
 // the FBXSDK_printf calls made here are all valid calls and there is no secuity risk
@@ -19,8 +20,10 @@
 void DisplayMetaDataConnections(FbxObject* pObject)
 {
 	int nbMetaData = pObject->GetSrcObjectCount<FbxObjectMetaData>();
-    if (nbMetaData > 0)
-        DisplayString("    MetaData connections ");
+    if (nbMetaData == 0 || !LogEnabled(eLogTrace))
+        return;
+
+    DisplayString("    MetaData connections ");
 
     for (int i = 0; i < nbMetaData; i++)
     {
@@ -29,172 +32,91 @@ void DisplayMetaDataConnections(FbxObject* pObject)
     }
 }
 
-void DisplayString(const char* pHeader, const char* pValue /* = "" */, const char* pSuffix /* = "" */)
+// All helpers print detail at trace level and return before building any text
+// when it is disabled.
+static const char* FloatText(double pValue, char* pBuffer, size_t pSize)
 {
-    FbxString lString;
+    if (pValue <= -HUGE_VAL) return "-INFINITY";
+    if (pValue >=  HUGE_VAL) return "INFINITY";
+    FBXSDK_sprintf(pBuffer, pSize, "%f", (float)pValue);
+    return pBuffer;
+}
 
-    lString = pHeader;
-    lString += pValue;
-    lString += pSuffix;
-    lString += "\n";
-    FBXSDK_printf(lString);
+void DisplayString(const char* pHeader, const char* pValue /* = "" */, const char* pSuffix /* = "" */)
+{
+    LOG_TRACE("%s%s%s\n", pHeader, pValue, pSuffix);
 }
 
 
 void DisplayBool(const char* pHeader, bool pValue, const char* pSuffix /* = "" */)
 {
-    FbxString lString;
-
-    lString = pHeader;
-    lString += pValue ? "true" : "false";
-    lString += pSuffix;
-    lString += "\n";
-    FBXSDK_printf(lString);
+    LOG_TRACE("%s%s%s\n", pHeader, pValue ? "true" : "false", pSuffix);
 }
 
 
 void DisplayInt(const char* pHeader, int pValue, const char* pSuffix /* = "" */)
 {
-    FbxString lString;
-
-    lString = pHeader;
-    lString += pValue;
-    lString += pSuffix;
-    lString += "\n";
-    FBXSDK_printf(lString);
+    LOG_TRACE("%s%d%s\n", pHeader, pValue, pSuffix);
 }
 
 
 void DisplayDouble(const char* pHeader, double pValue, const char* pSuffix /* = "" */)
 {
-    FbxString lString;
-    FbxString lFloatValue = (float) pValue;
+    if (!LogEnabled(eLogTrace))
+        return;
 
-    lFloatValue = pValue <= -HUGE_VAL ? "-INFINITY" : lFloatValue.Buffer();
-    lFloatValue = pValue >=  HUGE_VAL ?  "INFINITY" : lFloatValue.Buffer();
-
-    lString = pHeader;
-    lString += lFloatValue;
-    lString += pSuffix;
-    lString += "\n";
-    FBXSDK_printf(lString);
+    char lValue[64];
+    LogWrite(eLogTrace, "%s%s%s\n", pHeader, FloatText(pValue, lValue, sizeof(lValue)), pSuffix);
 }
 
 
 void Display2DVector(const char* pHeader, FbxVector2 pValue, const char* pSuffix  /* = "" */)
 {
-    FbxString lString;
-    FbxString lFloatValue1 = (float)pValue[0];
-    FbxString lFloatValue2 = (float)pValue[1];
-
-    lFloatValue1 = pValue[0] <= -HUGE_VAL ? "-INFINITY" : lFloatValue1.Buffer();
-    lFloatValue1 = pValue[0] >=  HUGE_VAL ?  "INFINITY" : lFloatValue1.Buffer();
-    lFloatValue2 = pValue[1] <= -HUGE_VAL ? "-INFINITY" : lFloatValue2.Buffer();
-    lFloatValue2 = pValue[1] >=  HUGE_VAL ?  "INFINITY" : lFloatValue2.Buffer();
-
-    lString = pHeader;
-    lString += lFloatValue1;
-    lString += ", ";
-    lString += lFloatValue2;
-    lString += pSuffix;
-    lString += "\n";
-    FBXSDK_printf(lString);
+    if (!LogEnabled(eLogTrace))
+        return;
+
+    char lValue1[64], lValue2[64];
+    LogWrite(eLogTrace, "%s%s, %s%s\n", pHeader,
+             FloatText(pValue[0], lValue1, sizeof(lValue1)),
+             FloatText(pValue[1], lValue2, sizeof(lValue2)), pSuffix);
 }
 
 
 void Display3DVector(const char* pHeader, FbxVector4 pValue, const char* pSuffix /* = "" */)
 {
-    FbxString lString;
-    FbxString lFloatValue1 = (float)pValue[0];
-    FbxString lFloatValue2 = (float)pValue[1];
-    FbxString lFloatValue3 = (float)pValue[2];
-
-    lFloatValue1 = pValue[0] <= -HUGE_VAL ? "-INFINITY" : lFloatValue1.Buffer();
-    lFloatValue1 = pValue[0] >=  HUGE_VAL ?  "INFINITY" : lFloatValue1.Buffer();
-    lFloatValue2 = pValue[1] <= -HUGE_VAL ? "-INFINITY" : lFloatValue2.Buffer();
-    lFloatValue2 = pValue[1] >=  HUGE_VAL ?  "INFINITY" : lFloatValue2.Buffer();
-    lFloatValue3 = pValue[2] <= -HUGE_VAL ? "-INFINITY" : lFloatValue3.Buffer();
-    lFloatValue3 = pValue[2] >=  HUGE_VAL ?  "INFINITY" : lFloatValue3.Buffer();
-
-    lString = pHeader;
-    lString += lFloatValue1;
-    lString += ", ";
-    lString += lFloatValue2;
-    lString += ", ";
-    lString += lFloatValue3;
-    lString += pSuffix;
-    lString += "\n";
-    FBXSDK_printf(lString);
+    if (!LogEnabled(eLogTrace))
+        return;
+
+    char lValue1[64], lValue2[64], lValue3[64];
+    LogWrite(eLogTrace, "%s%s, %s, %s%s\n", pHeader,
+             FloatText(pValue[0], lValue1, sizeof(lValue1)),
+             FloatText(pValue[1], lValue2, sizeof(lValue2)),
+             FloatText(pValue[2], lValue3, sizeof(lValue3)), pSuffix);
 }
 
 void Display4DVector(const char* pHeader, FbxVector4 pValue, const char* pSuffix /* = "" */)
 {
-    FbxString lString;
-    FbxString lFloatValue1 = (float)pValue[0];
-    FbxString lFloatValue2 = (float)pValue[1];
-    FbxString lFloatValue3 = (float)pValue[2];
-    FbxString lFloatValue4 = (float)pValue[3];
-
-    lFloatValue1 = pValue[0] <= -HUGE_VAL ? "-INFINITY" : lFloatValue1.Buffer();
-    lFloatValue1 = pValue[0] >=  HUGE_VAL ?  "INFINITY" : lFloatValue1.Buffer();
-    lFloatValue2 = pValue[1] <= -HUGE_VAL ? "-INFINITY" : lFloatValue2.Buffer();
-    lFloatValue2 = pValue[1] >=  HUGE_VAL ?  "INFINITY" : lFloatValue2.Buffer();
-    lFloatValue3 = pValue[2] <= -HUGE_VAL ? "-INFINITY" : lFloatValue3.Buffer();
-    lFloatValue3 = pValue[2] >=  HUGE_VAL ?  "INFINITY" : lFloatValue3.Buffer();
-    lFloatValue4 = pValue[3] <= -HUGE_VAL ? "-INFINITY" : lFloatValue4.Buffer();
-    lFloatValue4 = pValue[3] >=  HUGE_VAL ?  "INFINITY" : lFloatValue4.Buffer();
-
-    lString = pHeader;
-    lString += lFloatValue1;
-    lString += ", ";
-    lString += lFloatValue2;
-    lString += ", ";
-    lString += lFloatValue3;
-    lString += ", ";
-    lString += lFloatValue4;
-    lString += pSuffix;
-    lString += "\n";
-    FBXSDK_printf(lString);
+    if (!LogEnabled(eLogTrace))
+        return;
+
+    char lValue1[64], lValue2[64], lValue3[64], lValue4[64];
+    LogWrite(eLogTrace, "%s%s, %s, %s, %s%s\n", pHeader,
+             FloatText(pValue[0], lValue1, sizeof(lValue1)),
+             FloatText(pValue[1], lValue2, sizeof(lValue2)),
+             FloatText(pValue[2], lValue3, sizeof(lValue3)),
+             FloatText(pValue[3], lValue4, sizeof(lValue4)), pSuffix);
 }
 
 
 void DisplayColor(const char* pHeader, FbxPropertyT<FbxDouble3> pValue, const char* pSuffix /* = "" */)
 
 {
-    FbxString lString;
-
-    lString = pHeader;
-    //lString += (float) pValue.mRed;
-    //lString += (double)pValue.GetArrayItem(0);
-    lString += " (red), ";
-    //lString += (float) pValue.mGreen;
-    //lString += (double)pValue.GetArrayItem(1);
-    lString += " (green), ";
-    //lString += (float) pValue.mBlue;
-    //lString += (double)pValue.GetArrayItem(2);
-    lString += " (blue)";
-    lString += pSuffix;
-    lString += "\n";
-    FBXSDK_printf(lString);
+    LOG_TRACE("%s (red),  (green),  (blue)%s\n", pHeader, pSuffix);
 }
 
 
 void DisplayColor(const char* pHeader, FbxColor pValue, const char* pSuffix /* = "" */)
 {
-    FbxString lString;
-
-    lString = pHeader;
-    lString += (float) pValue.mRed;
-
-    lString += " (red), ";
-    lString += (float) pValue.mGreen;
-
-    lString += " (green), ";
-    lString += (float) pValue.mBlue;
-
-    lString += " (blue)";
-    lString += pSuffix;
-    lString += "\n";
-    FBXSDK_printf(lString);
+    LOG_TRACE("%s%f (red), %f (green), %f (blue)%s\n", pHeader,
+              (float)pValue.mRed, (float)pValue.mGreen, (float)pValue.mBlue, pSuffix);
 }
-
@@ -10,6 +10,7 @@
 ****************************************************************************************/
 
 #include <fbxsdk.h>
+#include "Common/Log.h"
 
 #if defined (FBXSDK_ENV_MAC)
 // disable the format not a string literal and no format arguments warning since
@@ -44,7 +45,7 @@ void DisplayHierarchy(FbxNode* pNode, int pDepth)
     lString += pNode->GetName();
     lString += "\n";
 
-    FBXSDK_printf(lString.Buffer());
+    LOG_TRACE("%s", lString.Buffer());
 
     for(i = 0; i < pNode->GetChildCount(); i++)
     {
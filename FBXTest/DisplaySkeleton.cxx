@@ -10,76 +10,94 @@
 ****************************************************************************************/
 
 #include <fbxsdk.h>
-#include <map>
-#include "DisplayCommon.h"
+#include "DisplaySkeleton.h"
+#include "Common/Log.h"
 #include <string>
-#include <set>
 
-void DisplaySkeleton(FbxNode* pNode, std::map<std::string, std::string> jointMap)
+void DisplaySkeleton(FbxNode* pNode, const JointMap& jointMap, RenameContext& pContext)
 {
-    static std::set<std::string> foundNodes = {};
-    for (int i = 2;! foundNodes.insert(std::string(pNode->GetName())).second; i++) {
-        FbxString stringName = pNode->GetName();
-        DisplayString("Found duplicate of: " + stringName);
-
-        char buffer[4];
-        sprintf(buffer, "%2d", i);
-        stringName.Append(buffer, strlen(buffer));
-
-        DisplayString("Renaming to: " + stringName);
-        pNode->SetName(stringName);
+    FileReport* lReport = pContext.mReport;
+    if (lReport)
+        lReport->BeginJoint(pNode->GetName());
+
+    std::string uniqueName;
+    if (!pContext.mNames.Resolve(pNode->GetName(), uniqueName)) {
+        LOG_TRACE("Found duplicate of %s, renaming to %s\n", pNode->GetName(), uniqueName.c_str());
+        ++pContext.mDuplicates;
+        pNode->SetName(uniqueName.c_str());
+        if (lReport)
+            lReport->JointUnique(uniqueName.c_str());
     }
 
     FbxSkeleton* lSkeleton = (FbxSkeleton*) pNode->GetNodeAttribute();
 
-    DisplayString("Skeleton Name: ", (char *) pNode->GetName());
+    LOG_TRACE("Skeleton Name: %s\n", pNode->GetName());
 
 
-	if (jointMap.find(std::string(pNode->GetName())) != jointMap.end()) {
-		FbxString stringName = jointMap[std::string(pNode->GetName())].c_str();
-
-		DisplayString("Setting name to: " + stringName);
-		pNode->SetName(stringName);
+	const char* newName = jointMap.Find(pNode->GetName());
+	if (lReport)
+		lReport->JointRenamed(newName);
+	++pContext.mJoints;
+	if (newName) {
+		LOG_TRACE("Renaming %s to %s\n", pNode->GetName(), newName);
+		pNode->SetName(newName);
+		++pContext.mRenamed;
 	}
 	else {
-		DisplayString("No new name for joint: ",  (char*)pNode->GetName());
+		LOG_TRACE("No new name for joint: %s\n", pNode->GetName());
 	}
 
 	
 
 
-    static bool root = true;
-    static double scale = 1.0;
-    if (root)
+    double& scale = pContext.mScale;
+    if (pContext.mRoot)
     {
-        root = false;
+        pContext.mRoot = false;
         scale = pNode->LclScaling.Get()[0];
         pNode->LclScaling.Set(FbxVectorTemplate3<double>(1.0, 1.0, 1.0));
-        FBXSDK_printf("Scaling root from %f to %f\n", scale, pNode->LclScaling.Get()[0]);
+        LOG_INFO("Scaling root from %f to %f\n", scale, pNode->LclScaling.Get()[0]);
+        if (lReport)
+            lReport->JointRootScale(scale);
     }
 
+    const double lFactor = scale * pContext.mUnitFactor;
     const char* lSkeletonTypes[] = { "Root", "Limb", "Limb Node", "Effector" };
 
     DisplayString("    Type: ", lSkeletonTypes[lSkeleton->GetSkeletonType()]);
+    if (lReport)
+        lReport->JointType(lSkeletonTypes[lSkeleton->GetSkeletonType()]);
 
     if (lSkeleton->GetSkeletonType() == FbxSkeleton::eLimb)
     {
-        DisplayDouble("    Limb Length: ", lSkeleton->LimbLength.Get());
-        lSkeleton->LimbLength.Set(lSkeleton->LimbLength.Get() * scale);
+        const double lLength = lSkeleton->LimbLength.Get();
+        DisplayDouble("    Limb Length: ", lLength);
+        lSkeleton->LimbLength.Set(lLength * lFactor);
         DisplayDouble("    New Length: ", lSkeleton->LimbLength.Get());
+        if (lReport)
+            lReport->JointSize(lLength, lSkeleton->LimbLength.Get());
     }
     else if (lSkeleton->GetSkeletonType() == FbxSkeleton::eLimbNode)
     {
-        DisplayDouble("    Limb Node Size: ", lSkeleton->Size.Get());
-        lSkeleton->Size.Set(lSkeleton->Size.Get() * scale);
+        const double lSize = lSkeleton->Size.Get();
+        DisplayDouble("    Limb Node Size: ", lSize);
+        lSkeleton->Size.Set(lSize * lFactor);
         DisplayDouble("    New Length: ", lSkeleton->Size.Get());
+        if (lReport)
+            lReport->JointSize(lSize, lSkeleton->Size.Get());
     }
     else if (lSkeleton->GetSkeletonType() == FbxSkeleton::eRoot)
     {
-        DisplayDouble("    Limb Root Size: ", lSkeleton->Size.Get());
-        lSkeleton->Size.Set(lSkeleton->Size.Get() * scale);
+        const double lSize = lSkeleton->Size.Get();
+        DisplayDouble("    Limb Root Size: ", lSize);
+        lSkeleton->Size.Set(lSize * lFactor);
         DisplayDouble("    New Length: ", lSkeleton->Size.Get());
+        if (lReport)
+            lReport->JointSize(lSize, lSkeleton->Size.Get());
     }
 
     DisplayColor("    Color: ", lSkeleton->GetLimbNodeColor());
+
+    if (lReport)
+        lReport->EndJoint();
 }
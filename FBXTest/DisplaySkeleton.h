@@ -13,9 +13,31 @@
 #define _DISPLAY_SKELETON_H
 
 #include "DisplayCommon.h"
-#include <map>
-
-void DisplaySkeleton(FbxNode* pNode, std::map<std::string, std::string> jointMap);
+#include "JointMap.h"
+#include "NameResolver.h"
+#include "RenameReport.h"
+
+/** State of the rename pass for one scene. A fresh context must be used for
+  * every scene, so scenes processed concurrently do not share names or root scale.
+  */
+struct RenameContext
+{
+    RenameContext() : mRoot(true), mScale(1.0), mUnitFactor(1.0), mReport(NULL), mJoints(0), mRenamed(0), mDuplicates(0) {}
+
+    NameResolver mNames;
+    bool mRoot;
+    double mScale;
+    // Unit conversion folded into the limb sizes; 1 when the scene is converted separately.
+    double mUnitFactor;
+    // If set, every joint and what was done to it is recorded here.
+    FileReport* mReport;
+    // Counts for the per-scene summary; the per-joint lines are only logged at trace level.
+    int mJoints;
+    int mRenamed;
+    int mDuplicates;
+};
+
+void DisplaySkeleton(FbxNode* pNode, const JointMap& jointMap, RenameContext& pContext);
 
 #endif // #ifndef _DISPLAY_SKELETON_H
 
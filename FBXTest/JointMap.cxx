@@ -0,0 +1,123 @@
+#include "JointMap.h"
+#include "Common/Hash64.h"
+#include "Common/Log.h"
+
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+JointMap::JointMap()
+    : mMask(0)
+    , mCount(0)
+    , mContentHash(0)
+{
+}
+
+bool JointMap::Load(const char* pFileName)
+{
+    mPool.clear();
+    mSlots.clear();
+    mMask = 0;
+    mCount = 0;
+    mContentHash = 0;
+
+    std::ifstream jfile(pFileName);
+    if (!jfile)
+        return false;
+
+    // Collect the entries first so duplicates resolve to the last line, as before.
+    std::map<std::string, std::string> lEntries;
+    std::string line;
+    while (std::getline(jfile, line))
+    {
+        if (!line.empty() && line[line.size() - 1] == '\r')
+            line.erase(line.size() - 1);
+
+        LOG_TRACE("Read line: %s\n", line.c_str());
+
+        std::istringstream is_line(line);
+        std::string key;
+        if (std::getline(is_line, key, '='))
+        {
+            std::string value;
+            if (std::getline(is_line, value))
+                lEntries[key] = value;
+        }
+    }
+
+    // Keep the load factor at or below one half.
+    unsigned int lCapacity = 16;
+    while (lCapacity < lEntries.size() * 2)
+        lCapacity *= 2;
+
+    Slot lEmpty = { 0, EMPTY, 0, 0 };
+    mSlots.assign(lCapacity, lEmpty);
+    mMask = lCapacity - 1;
+
+    size_t lPoolSize = 0;
+    for (std::map<std::string, std::string>::const_iterator it = lEntries.begin(); it != lEntries.end(); ++it)
+        lPoolSize += it->first.size() + it->second.size() + 2;
+    mPool.reserve(lPoolSize);
+
+    for (std::map<std::string, std::string>::const_iterator it = lEntries.begin(); it != lEntries.end(); ++it)
+        Insert(it->first, it->second);
+
+    // The pool holds the entries sorted by old name, so it is already a normal form.
+    mContentHash = Hash64(mPool);
+
+    return true;
+}
+
+const char* JointMap::Find(const char* pName) const
+{
+    return Find(pName, strlen(pName));
+}
+
+const char* JointMap::Find(const char* pName, size_t pLength) const
+{
+    if (mCount == 0)
+        return NULL;
+
+    unsigned int lHash = Hash(pName, pLength);
+    for (unsigned int i = lHash & mMask;; i = (i + 1) & mMask)
+    {
+        const Slot& lSlot = mSlots[i];
+        if (lSlot.mKey == EMPTY)
+            return NULL;
+
+        if (lSlot.mHash == lHash && lSlot.mKeyLength == pLength && memcmp(mPool.data() + lSlot.mKey, pName, pLength) == 0)
+            return mPool.c_str() + lSlot.mValue;
+    }
+}
+
+unsigned int JointMap::Hash(const char* pName, size_t pLength)
+{
+    // 32 bit FNV-1a.
+    unsigned int lHash = 2166136261u;
+    for (size_t i = 0; i < pLength; ++i)
+    {
+        lHash ^= (unsigned char)pName[i];
+        lHash *= 16777619u;
+    }
+    return lHash;
+}
+
+void JointMap::Insert(const std::string& pKey, const std::string& pValue)
+{
+    Slot lSlot;
+    lSlot.mHash = Hash(pKey.c_str(), pKey.size());
+    lSlot.mKey = (unsigned int)mPool.size();
+    lSlot.mKeyLength = (unsigned int)pKey.size();
+    mPool.append(pKey.c_str(), pKey.size() + 1);
+    lSlot.mValue = (unsigned int)mPool.size();
+    mPool.append(pValue.c_str(), pValue.size() + 1);
+
+    // Keys are unique here, so the first free slot is the right one.
+    unsigned int i = lSlot.mHash & mMask;
+    while (mSlots[i].mKey != EMPTY)
+        i = (i + 1) & mMask;
+
+    mSlots[i] = lSlot;
+    ++mCount;
+}
@@ -0,0 +1,64 @@
+#ifndef _JOINT_MAP_H
+#define _JOINT_MAP_H
+
+#include <string>
+#include <vector>
+
+/** Immutable old to new joint name table, built once from jointmap.cfg.
+  *
+  * All names are interned into one string pool and indexed by an open addressing
+  * hash table with linear probing, so a lookup is one hash plus, on average, about
+  * one string compare and never allocates. After Load() returns the map is only read,
+  * so a single instance can be shared by every node and every worker thread.
+  */
+class JointMap
+{
+public:
+    JointMap();
+
+    /** Read a joint map file with one "oldName=newName" entry per line.
+      * A later entry for the same old name replaces the earlier one.
+      * /param pFileName The file to read.
+      * /return false if the file could not be opened; the map is then empty.
+      */
+    bool Load(const char* pFileName);
+
+    /** Look up the new name of a joint.
+      * /param pName The current joint name.
+      * /return The new name, or NULL if the joint is not mapped.
+      */
+    const char* Find(const char* pName) const;
+
+    /** Same as Find(const char*) for names that are not NUL terminated. */
+    const char* Find(const char* pName, size_t pLength) const;
+
+    /** Number of mapped joints. */
+    size_t GetCount() const { return mCount; }
+
+    /** Hash of the effective entries, independent of line order, comments,
+      * line endings and overridden duplicates in the file.
+      */
+    unsigned long long GetContentHash() const { return mContentHash; }
+
+private:
+    struct Slot
+    {
+        unsigned int mHash;
+        unsigned int mKey;      // Offset of the old name in mPool, or EMPTY.
+        unsigned int mKeyLength;
+        unsigned int mValue;    // Offset of the NUL terminated new name in mPool.
+    };
+
+    static const unsigned int EMPTY = 0xFFFFFFFFu;
+
+    static unsigned int Hash(const char* pName, size_t pLength);
+    void Insert(const std::string& pKey, const std::string& pValue);
+
+    std::string mPool;
+    std::vector<Slot> mSlots;
+    unsigned int mMask;
+    size_t mCount;
+    unsigned long long mContentHash;
+};
+
+#endif // #ifndef _JOINT_MAP_H
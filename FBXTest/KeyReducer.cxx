@@ -0,0 +1,105 @@
+#include "KeyReducer.h"
+#include "Common/Log.h"
+
+#include <vector>
+
+/** Replace a single key curve by its value on every curve node channel it drives. */
+static bool RemoveConstantCurve(FbxAnimCurve* pCurve)
+{
+    const float lValue = pCurve->KeyGetCount() > 0 ? pCurve->KeyGetValue(0) : 0.0f;
+
+    // Collect first; disconnecting changes the destination list.
+    std::vector<FbxAnimCurveNode*> lNodes;
+    for (int i = 0; i < pCurve->GetDstObjectCount<FbxAnimCurveNode>(); ++i)
+        lNodes.push_back(pCurve->GetDstObject<FbxAnimCurveNode>(i));
+    if (lNodes.empty())
+        return false;
+
+    for (size_t i = 0; i < lNodes.size(); ++i)
+    {
+        FbxAnimCurveNode* lNode = lNodes[i];
+        for (unsigned int c = 0; c < lNode->GetChannelsCount(); ++c)
+        {
+            for (int j = lNode->GetCurveCount(c) - 1; j >= 0; --j)
+            {
+                if (lNode->GetCurve(c, j) == pCurve)
+                {
+                    lNode->SetChannelValue<double>(c, lValue);
+                    lNode->DisconnectFromChannel(pCurve, c);
+                }
+            }
+        }
+    }
+
+    pCurve->Destroy();
+    return true;
+}
+
+/** The two filters of one channel kind, set up for its tolerance. */
+struct ChannelReducer
+{
+    explicit ChannelReducer(double pTolerance)
+    {
+        mConstantReducer.SetValueTolerance(pTolerance);
+        mConstantReducer.SetKeepFirstAndLastKeys(false);
+        mConstantReducer.SetKeepOneKey(true);
+        mKeyReducer.SetPrecision(pTolerance);
+        mKeyReducer.SetKeySync(false);
+    }
+
+    FbxAnimCurveFilterConstantKeyReducer mConstantReducer;
+    FbxAnimCurveFilterKeyReducer mKeyReducer;
+};
+
+/** true if pCurve drives the Lcl Scaling property of a node. */
+static bool IsScalingCurve(FbxAnimCurve* pCurve)
+{
+    FbxAnimCurveNode* lNode = pCurve->GetDstObject<FbxAnimCurveNode>(0);
+    if (!lNode)
+        return false;
+    FbxProperty lProperty = lNode->GetDstProperty(0);
+    return lProperty.IsValid() && lProperty.GetName() == "Lcl Scaling";
+}
+
+void ReduceSceneKeys(FbxScene* pScene, double pTolerance, KeyReductionResult& pResult)
+{
+    // Translation is in centimeters and rotation in degrees, so both use the tolerance as is.
+    ChannelReducer lReducer(pTolerance);
+    ChannelReducer lScalingReducer(pTolerance * SCALE_TOLERANCE_PER_CM);
+
+    // Removing constant curves destroys objects, so work on a snapshot.
+    std::vector<FbxAnimCurve*> lCurves;
+    const int lCurveCount = pScene->GetSrcObjectCount<FbxAnimCurve>();
+    lCurves.reserve(lCurveCount);
+    for (int i = 0; i < lCurveCount; ++i)
+        lCurves.push_back(pScene->GetSrcObject<FbxAnimCurve>(i));
+
+    for (size_t i = 0; i < lCurves.size(); ++i)
+    {
+        FbxAnimCurve* lCurve = lCurves[i];
+        const int lBefore = lCurve->KeyGetCount();
+        ++pResult.mCurves;
+        pResult.mKeysBefore += lBefore;
+        // A curve without keys has no value to keep, so it is left alone.
+        if (lBefore == 0)
+            continue;
+
+        if (lBefore > 1)
+        {
+            ChannelReducer& lChannel = IsScalingCurve(lCurve) ? lScalingReducer : lReducer;
+            lChannel.mConstantReducer.Apply(*lCurve);
+            if (lCurve->KeyGetCount() > 2)
+                lChannel.mKeyReducer.Apply(*lCurve);
+        }
+
+        if (lCurve->KeyGetCount() <= 1 && RemoveConstantCurve(lCurve))
+        {
+            ++pResult.mConstantCurves;
+            continue;
+        }
+        pResult.mKeysAfter += lCurve->KeyGetCount();
+    }
+
+    LOG_INFO("Key reduction: %lld keys to %lld in %d curves, %d constant curves removed\n",
+             pResult.mKeysBefore, pResult.mKeysAfter, pResult.mCurves, pResult.mConstantCurves);
+}
@@ -0,0 +1,43 @@
+#ifndef _KEY_REDUCER_H
+#define _KEY_REDUCER_H
+
+#include <fbxsdk.h>
+
+struct KeyReductionResult
+{
+    KeyReductionResult() : mCurves(0), mConstantCurves(0), mKeysBefore(0), mKeysAfter(0) {}
+
+    int mCurves;
+    int mConstantCurves;        // Removed and replaced by their channel value.
+    long long mKeysBefore;
+    long long mKeysAfter;
+};
+
+/** Tolerance of scaling curves per unit of translation tolerance: 1 cm allows a
+  * scale error of 0.01. Scale is a ratio, so the translation tolerance itself would
+  * flatten all but large scale animation.
+  */
+static const double SCALE_TOLERANCE_PER_CM = 0.01;
+
+/** Remove redundant keys from every animation curve of a scene.
+  *
+  * Each curve first goes through FbxAnimCurveFilterConstantKeyReducer, which
+  * drops runs of keys with equal values, then FbxAnimCurveFilterKeyReducer,
+  * which drops keys the curve can interpolate within the tolerance. A curve left
+  * with a single key is constant; it is disconnected and its value becomes the
+  * channel value of its curve node.
+  *
+  * pTolerance is in centimeters for translation curves and in degrees for
+  * rotation curves. Scaling curves use pTolerance * SCALE_TOLERANCE_PER_CM, and
+  * any other animated property uses pTolerance in its own units.
+  *
+  * The filters raise change notifications through curve nodes and the scene, so
+  * this runs on the calling thread.
+  *
+  * /param pScene The scene to reduce, after all value changing passes.
+  * /param pTolerance Largest allowed translation error in centimeters, see above.
+  * /param pResult Receives curve and key counts.
+  */
+void ReduceSceneKeys(FbxScene* pScene, double pTolerance, KeyReductionResult& pResult);
+
+#endif // #ifndef _KEY_REDUCER_H
@@ -0,0 +1,255 @@
+#include "MemoryTracker.h"
+#include "Common/Log.h"
+#include "Common/ThreadLocal.h"
+
+#include <fbxsdk.h>
+
+#include <atomic>
+#include <new>
+#include <string.h>
+
+static const size_t ARENA_CHUNK_SIZE = 1024 * 1024;
+// Larger blocks go straight to the heap, so a chunk never holds just a few of them.
+static const size_t ARENA_MAX_BLOCK = ARENA_CHUNK_SIZE / 8;
+// Header sizes and arena offsets are kept at the heap's 16 byte alignment.
+static const size_t MEMORY_ALIGNMENT = 16;
+
+struct ArenaChunk
+{
+    // One reference per live block, plus one held by the owning thread while it
+    // still allocates from the chunk. The chunk is freed when this drops to zero.
+    std::atomic<long> mReferences;
+    size_t mUsed;
+};
+
+// Placed in front of every block handed to the SDK.
+struct BlockHeader
+{
+    size_t mSize;
+    ArenaChunk* mChunk;         // NULL for blocks from the heap.
+};
+
+static const size_t CHUNK_HEADER_SIZE = (sizeof(ArenaChunk) + MEMORY_ALIGNMENT - 1) & ~(MEMORY_ALIGNMENT - 1);
+static const size_t BLOCK_HEADER_SIZE = (sizeof(BlockHeader) + MEMORY_ALIGNMENT - 1) & ~(MEMORY_ALIGNMENT - 1);
+
+static bool gInstalled = false;
+static bool gArenaEnabled = false;
+static FbxMallocProc gHeapMalloc = NULL;
+static FbxReallocProc gHeapRealloc = NULL;
+static FbxFreeProc gHeapFree = NULL;
+
+static std::atomic<long long> gCalls(0);
+static std::atomic<long long> gBytes(0);
+static std::atomic<long long> gLiveBytes(0);
+static std::atomic<long long> gPeakBytes(0);
+static std::atomic<long long> gArenaChunks(0);
+static std::atomic<long long> gArenaChunksFreed(0);
+
+static THREAD_LOCAL long long gThreadCalls = 0;
+static THREAD_LOCAL long long gThreadBytes = 0;
+static THREAD_LOCAL bool gThreadArena = false;
+static THREAD_LOCAL ArenaChunk* gThreadChunk = NULL;
+
+static void CountAllocation(size_t pSize)
+{
+    ++gThreadCalls;
+    gThreadBytes += (long long)pSize;
+    ++gCalls;
+    gBytes += (long long)pSize;
+
+    const long long lLive = gLiveBytes.fetch_add((long long)pSize) + (long long)pSize;
+    long long lPeak = gPeakBytes.load();
+    while (lLive > lPeak && !gPeakBytes.compare_exchange_weak(lPeak, lLive))
+    {
+    }
+}
+
+static void ReleaseChunk(ArenaChunk* pChunk)
+{
+    if (--pChunk->mReferences == 0)
+    {
+        pChunk->~ArenaChunk();
+        gHeapFree(pChunk);
+        ++gArenaChunksFreed;
+    }
+}
+
+static BlockHeader* ArenaAllocate(size_t pSize)
+{
+    const size_t lNeeded = (BLOCK_HEADER_SIZE + pSize + MEMORY_ALIGNMENT - 1) & ~(MEMORY_ALIGNMENT - 1);
+    ArenaChunk* lChunk = gThreadChunk;
+    if (!lChunk || lChunk->mUsed + lNeeded > ARENA_CHUNK_SIZE)
+    {
+        void* lMemory = gHeapMalloc(ARENA_CHUNK_SIZE);
+        if (!lMemory)
+            return NULL;
+        if (lChunk)
+            ReleaseChunk(lChunk);
+        lChunk = new (lMemory) ArenaChunk;
+        lChunk->mReferences = 1;
+        lChunk->mUsed = CHUNK_HEADER_SIZE;
+        gThreadChunk = lChunk;
+        ++gArenaChunks;
+    }
+
+    BlockHeader* lHeader = (BlockHeader*)((char*)lChunk + lChunk->mUsed);
+    lChunk->mUsed += lNeeded;
+    ++lChunk->mReferences;
+    lHeader->mChunk = lChunk;
+    return lHeader;
+}
+
+static void* TrackedMalloc(size_t pSize)
+{
+    BlockHeader* lHeader = NULL;
+    if (gThreadArena && pSize <= ARENA_MAX_BLOCK)
+    {
+        lHeader = ArenaAllocate(pSize);
+    }
+    else
+    {
+        lHeader = (BlockHeader*)gHeapMalloc(BLOCK_HEADER_SIZE + pSize);
+        if (lHeader)
+            lHeader->mChunk = NULL;
+    }
+    if (!lHeader)
+        return NULL;
+
+    lHeader->mSize = pSize;
+    CountAllocation(pSize);
+    return (char*)lHeader + BLOCK_HEADER_SIZE;
+}
+
+static BlockHeader* GetHeader(void* pBlock)
+{
+    return (BlockHeader*)((char*)pBlock - BLOCK_HEADER_SIZE);
+}
+
+static void TrackedFree(void* pBlock)
+{
+    if (!pBlock)
+        return;
+
+    BlockHeader* lHeader = GetHeader(pBlock);
+    gLiveBytes -= (long long)lHeader->mSize;
+    if (lHeader->mChunk)
+        ReleaseChunk(lHeader->mChunk);
+    else
+        gHeapFree(lHeader);
+}
+
+static void* TrackedCalloc(size_t pCount, size_t pSize)
+{
+    if (pSize != 0 && pCount > (size_t)-1 / pSize)
+        return NULL;
+    void* lBlock = TrackedMalloc(pCount * pSize);
+    if (lBlock)
+        memset(lBlock, 0, pCount * pSize);
+    return lBlock;
+}
+
+static void* TrackedRealloc(void* pBlock, size_t pSize)
+{
+    if (!pBlock)
+        return TrackedMalloc(pSize);
+    if (pSize == 0)
+    {
+        TrackedFree(pBlock);
+        return NULL;
+    }
+
+    BlockHeader* lHeader = GetHeader(pBlock);
+    const size_t lOldSize = lHeader->mSize;
+
+    // Heap blocks that stay on the heap can grow in place.
+    if (!lHeader->mChunk && !(gThreadArena && pSize <= ARENA_MAX_BLOCK))
+    {
+        BlockHeader* lNewHeader = (BlockHeader*)gHeapRealloc(lHeader, BLOCK_HEADER_SIZE + pSize);
+        if (!lNewHeader)
+            return NULL;
+        gLiveBytes -= (long long)lOldSize;
+        lNewHeader->mSize = pSize;
+        CountAllocation(pSize);
+        return (char*)lNewHeader + BLOCK_HEADER_SIZE;
+    }
+
+    void* lNewBlock = TrackedMalloc(pSize);
+    if (!lNewBlock)
+        return NULL;
+    memcpy(lNewBlock, pBlock, lOldSize < pSize ? lOldSize : pSize);
+    TrackedFree(pBlock);
+    return lNewBlock;
+}
+
+void InstallAllocationTracker(bool pArena)
+{
+    if (gInstalled)
+        return;
+
+    gHeapMalloc = FbxGetMallocHandler();
+    gHeapRealloc = FbxGetReallocHandler();
+    gHeapFree = FbxGetFreeHandler();
+    gArenaEnabled = pArena;
+    gInstalled = true;
+
+    FbxSetMallocHandler(TrackedMalloc);
+    FbxSetCallocHandler(TrackedCalloc);
+    FbxSetReallocHandler(TrackedRealloc);
+    FbxSetFreeHandler(TrackedFree);
+}
+
+bool IsAllocationTrackerInstalled()
+{
+    return gInstalled;
+}
+
+AllocationCounters GetThreadAllocations()
+{
+    AllocationCounters lCounters;
+    lCounters.mCalls = gThreadCalls;
+    lCounters.mBytes = gThreadBytes;
+    return lCounters;
+}
+
+AllocationSummary GetAllocationSummary()
+{
+    AllocationSummary lSummary;
+    lSummary.mCalls = gCalls;
+    lSummary.mBytes = gBytes;
+    lSummary.mLiveBytes = gLiveBytes;
+    lSummary.mPeakBytes = gPeakBytes;
+    lSummary.mArenaChunks = gArenaChunks;
+    lSummary.mArenaChunksFreed = gArenaChunksFreed;
+    return lSummary;
+}
+
+void BeginAllocationArena()
+{
+    if (!gArenaEnabled)
+        return;
+    EndAllocationArena();
+    gThreadArena = true;
+}
+
+void EndAllocationArena()
+{
+    gThreadArena = false;
+    if (gThreadChunk)
+    {
+        ReleaseChunk(gThreadChunk);
+        gThreadChunk = NULL;
+    }
+}
+
+void LogAllocationSummary()
+{
+    if (!gInstalled)
+        return;
+
+    const AllocationSummary lSummary = GetAllocationSummary();
+    const double lMegabyte = 1024.0 * 1024.0;
+    LOG_INFO("SDK allocations: %lld calls, %.1f MB total, %.1f MB peak, %.1f MB still allocated\n",
+             lSummary.mCalls, lSummary.mBytes / lMegabyte, lSummary.mPeakBytes / lMegabyte, lSummary.mLiveBytes / lMegabyte);
+    if (gArenaEnabled)
+        LOG_INFO("Job arenas: %lld chunks, %lld released\n", lSummary.mArenaChunks, lSummary.mArenaChunksFreed);
+}
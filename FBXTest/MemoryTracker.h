@@ -0,0 +1,60 @@
+#ifndef _MEMORY_TRACKER_H
+#define _MEMORY_TRACKER_H
+
+#include <stddef.h>
+
+/** Allocations made through the FBX SDK by one thread since it started.
+  * Both counters only grow; take differences to charge a span of work.
+  */
+struct AllocationCounters
+{
+    long long mCalls;
+    long long mBytes;
+};
+
+/** Process wide totals since the handlers were installed. */
+struct AllocationSummary
+{
+    long long mCalls;
+    long long mBytes;
+    long long mLiveBytes;
+    long long mPeakBytes;
+    long long mArenaChunks;         // Chunks created by job arenas.
+    long long mArenaChunksFreed;    // Chunks released because every block in them was freed.
+};
+
+/** Route every FBX SDK allocation through counting handlers.
+  *
+  * Must be called once, before anything allocates through the SDK; that includes
+  * FbxString, not just the first FbxManager. Blocks carry a small header, so
+  * memory allocated by the default handlers must never reach these ones. The handlers stay installed until the process exits.
+  *
+  * With pArena, threads between BeginAllocationArena and EndAllocationArena
+  * allocate small blocks from 1 MB chunks that belong to the current job. A
+  * chunk is released as a whole once the job has ended and every block in it
+  * was freed, so objects of one job never share heap pages with long lived
+  * ones. Blocks the SDK keeps beyond the job only pin their own chunk.
+  */
+void InstallAllocationTracker(bool pArena);
+
+bool IsAllocationTrackerInstalled();
+
+/** Counters of the calling thread; zero if the tracker is not installed. */
+AllocationCounters GetThreadAllocations();
+
+AllocationSummary GetAllocationSummary();
+
+/** Start allocating the calling thread's small blocks from a fresh arena.
+  * Does nothing unless the tracker was installed with arenas.
+  */
+void BeginAllocationArena();
+
+/** Stop using the calling thread's arena. Its chunks are released as soon as
+  * their last block is freed, which may be right away.
+  */
+void EndAllocationArena();
+
+/** Log the process wide totals at info level, if the tracker is installed. */
+void LogAllocationSummary();
+
+#endif // #ifndef _MEMORY_TRACKER_H
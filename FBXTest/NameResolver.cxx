@@ -0,0 +1,28 @@
+#include "NameResolver.h"
+
+#include <stdio.h>
+
+bool NameResolver::Resolve(const char* pName, std::string& pResolved)
+{
+    pResolved = pName;
+    std::pair<std::unordered_map<std::string, int>::iterator, bool> lInserted =
+        mNames.insert(std::make_pair(pResolved, 2));
+    if (lInserted.second)
+        return true;
+
+    // A candidate can still collide with a name that exists literally in the
+    // scene, so keep counting until one is free. The counter only moves forward.
+    int& lNext = lInserted.first->second;
+    const std::string lBase = pResolved;
+    char lSuffix[16];
+    do
+    {
+        // Same "%2d" suffix as earlier versions, but always on the base name: the
+        // third "Bone" is "Bone 3", where they wrote "Bone 2 3".
+        sprintf(lSuffix, "%2d", lNext++);
+        pResolved = lBase + lSuffix;
+    }
+    while (!mNames.insert(std::make_pair(pResolved, 2)).second);
+
+    return false;
+}
@@ -0,0 +1,30 @@
+#ifndef _NAME_RESOLVER_H
+#define _NAME_RESOLVER_H
+
+#include <string>
+#include <unordered_map>
+
+/** Makes node names unique within one scene.
+  *
+  * The first node with a name keeps it. Later ones get the next free numeric
+  * suffix of that base name, e.g. "Bone", "Bone 2", "Bone 3". Every name in use
+  * maps to the next suffix to try for it, so resolving the n-th duplicate of a
+  * name does not retry the n - 1 suffixes before it.
+  */
+class NameResolver
+{
+public:
+    /** Claim pName, or a suffixed variant of it if it is already taken.
+      * /param pName The name the node has.
+      * /param pResolved Receives the name the node must use.
+      * /return false if pName was already taken and pResolved differs from it.
+      */
+    bool Resolve(const char* pName, std::string& pResolved);
+
+    void Clear() { mNames.clear(); }
+
+private:
+    std::unordered_map<std::string, int> mNames;
+};
+
+#endif // #ifndef _NAME_RESOLVER_H
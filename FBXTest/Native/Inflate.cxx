@@ -0,0 +1,334 @@
+#include "Inflate.h"
+
+#include <cstring>
+
+static const int MAX_CODE_BITS = 15;
+static const int MAX_LENGTH_CODES = 286;
+static const int MAX_DISTANCE_CODES = 30;
+static const int FIXED_LENGTH_CODES = 288;
+
+static const unsigned short LENGTH_BASE[29] =
+{
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+static const unsigned char LENGTH_EXTRA[29] =
+{
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+static const unsigned short DISTANCE_BASE[30] =
+{
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073,
+    4097, 6145, 8193, 12289, 16385, 24577
+};
+static const unsigned char DISTANCE_EXTRA[30] =
+{
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+static const unsigned char CODE_LENGTH_ORDER[19] =
+{
+    16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15
+};
+
+// Canonical Huffman code: the number of codes of each length and the symbols
+// ordered by code.
+struct Huffman
+{
+    short mCount[MAX_CODE_BITS + 1];
+    short mSymbol[FIXED_LENGTH_CODES];
+};
+
+struct InflateState
+{
+    const unsigned char* mData;
+    size_t mSize;
+    size_t mPosition;
+    unsigned int mBits;
+    int mBitCount;
+    unsigned char* mOutput;
+    size_t mOutputSize;
+    size_t mWritten;
+    bool mError;
+};
+
+static unsigned int ReadBits(InflateState& pState, int pCount)
+{
+    while (pState.mBitCount < pCount)
+    {
+        if (pState.mPosition >= pState.mSize)
+        {
+            pState.mError = true;
+            return 0;
+        }
+        pState.mBits |= (unsigned int)pState.mData[pState.mPosition++] << pState.mBitCount;
+        pState.mBitCount += 8;
+    }
+
+    unsigned int lValue = pState.mBits & ((1u << pCount) - 1);
+    pState.mBits >>= pCount;
+    pState.mBitCount -= pCount;
+    return lValue;
+}
+
+/** Build a decoding table from code lengths. Incomplete codes are allowed, as
+  * zlib writes them for single distance codes; over-subscribed ones are not.
+  */
+static bool BuildHuffman(Huffman& pCode, const unsigned char* pLengths, int pCount)
+{
+    memset(pCode.mCount, 0, sizeof(pCode.mCount));
+    for (int i = 0; i < pCount; ++i)
+        ++pCode.mCount[pLengths[i]];
+
+    int lLeft = 1;
+    for (int lLength = 1; lLength <= MAX_CODE_BITS; ++lLength)
+    {
+        lLeft = (lLeft << 1) - pCode.mCount[lLength];
+        if (lLeft < 0)
+            return false;
+    }
+
+    short lOffsets[MAX_CODE_BITS + 1];
+    lOffsets[1] = 0;
+    for (int lLength = 1; lLength < MAX_CODE_BITS; ++lLength)
+        lOffsets[lLength + 1] = lOffsets[lLength] + pCode.mCount[lLength];
+    for (int i = 0; i < pCount; ++i)
+    {
+        if (pLengths[i] != 0)
+            pCode.mSymbol[lOffsets[pLengths[i]]++] = (short)i;
+    }
+    return true;
+}
+
+/** Read one symbol; -1 on a code that is not in the table or at the end of input. */
+static int DecodeSymbol(InflateState& pState, const Huffman& pCode)
+{
+    int lCode = 0;
+    int lFirst = 0;
+    int lIndex = 0;
+    for (int lLength = 1; lLength <= MAX_CODE_BITS; ++lLength)
+    {
+        lCode |= (int)ReadBits(pState, 1);
+        if (pState.mError)
+            return -1;
+
+        int lCount = pCode.mCount[lLength];
+        if (lCode - lCount < lFirst)
+            return pCode.mSymbol[lIndex + (lCode - lFirst)];
+        lIndex += lCount;
+        lFirst = (lFirst + lCount) << 1;
+        lCode <<= 1;
+    }
+    return -1;
+}
+
+static bool InflateStored(InflateState& pState)
+{
+    // Stored blocks start at the next byte boundary.
+    pState.mBits = 0;
+    pState.mBitCount = 0;
+    if (pState.mPosition + 4 > pState.mSize)
+        return false;
+
+    const unsigned char* lHeader = pState.mData + pState.mPosition;
+    unsigned int lLength = lHeader[0] | (lHeader[1] << 8);
+    unsigned int lComplement = lHeader[2] | (lHeader[3] << 8);
+    pState.mPosition += 4;
+    if (lLength != (~lComplement & 0xFFFF) || pState.mPosition + lLength > pState.mSize ||
+        pState.mWritten + lLength > pState.mOutputSize)
+        return false;
+
+    memcpy(pState.mOutput + pState.mWritten, pState.mData + pState.mPosition, lLength);
+    pState.mPosition += lLength;
+    pState.mWritten += lLength;
+    return true;
+}
+
+static bool InflateCodes(InflateState& pState, const Huffman& pLengthCode, const Huffman& pDistanceCode)
+{
+    for (;;)
+    {
+        int lSymbol = DecodeSymbol(pState, pLengthCode);
+        if (lSymbol < 0)
+            return false;
+        if (lSymbol == 256)
+            return true;
+
+        if (lSymbol < 256)
+        {
+            if (pState.mWritten >= pState.mOutputSize)
+                return false;
+            pState.mOutput[pState.mWritten++] = (unsigned char)lSymbol;
+            continue;
+        }
+
+        lSymbol -= 257;
+        if (lSymbol >= 29)
+            return false;
+        size_t lLength = LENGTH_BASE[lSymbol] + ReadBits(pState, LENGTH_EXTRA[lSymbol]);
+
+        int lDistanceSymbol = DecodeSymbol(pState, pDistanceCode);
+        if (lDistanceSymbol < 0 || lDistanceSymbol >= MAX_DISTANCE_CODES)
+            return false;
+        size_t lDistance = DISTANCE_BASE[lDistanceSymbol] + ReadBits(pState, DISTANCE_EXTRA[lDistanceSymbol]);
+        if (pState.mError || lDistance > pState.mWritten || pState.mWritten + lLength > pState.mOutputSize)
+            return false;
+
+        // Matches may overlap their own output, so copy byte by byte.
+        unsigned char* lTarget = pState.mOutput + pState.mWritten;
+        const unsigned char* lSource = lTarget - lDistance;
+        for (size_t i = 0; i < lLength; ++i)
+            lTarget[i] = lSource[i];
+        pState.mWritten += lLength;
+    }
+}
+
+static bool InflateFixed(InflateState& pState)
+{
+    unsigned char lLengths[FIXED_LENGTH_CODES];
+    int i = 0;
+    for (; i < 144; ++i) lLengths[i] = 8;
+    for (; i < 256; ++i) lLengths[i] = 9;
+    for (; i < 280; ++i) lLengths[i] = 7;
+    for (; i < FIXED_LENGTH_CODES; ++i) lLengths[i] = 8;
+
+    Huffman lLengthCode;
+    BuildHuffman(lLengthCode, lLengths, FIXED_LENGTH_CODES);
+
+    memset(lLengths, 5, MAX_DISTANCE_CODES);
+    Huffman lDistanceCode;
+    BuildHuffman(lDistanceCode, lLengths, MAX_DISTANCE_CODES);
+
+    return InflateCodes(pState, lLengthCode, lDistanceCode);
+}
+
+static bool InflateDynamic(InflateState& pState)
+{
+    const int lLengthCount = (int)ReadBits(pState, 5) + 257;
+    const int lDistanceCount = (int)ReadBits(pState, 5) + 1;
+    const int lCodeLengthCount = (int)ReadBits(pState, 4) + 4;
+    if (pState.mError || lLengthCount > MAX_LENGTH_CODES || lDistanceCount > MAX_DISTANCE_CODES)
+        return false;
+
+    unsigned char lLengths[MAX_LENGTH_CODES + MAX_DISTANCE_CODES];
+    memset(lLengths, 0, 19);
+    for (int i = 0; i < lCodeLengthCount; ++i)
+        lLengths[CODE_LENGTH_ORDER[i]] = (unsigned char)ReadBits(pState, 3);
+
+    Huffman lCodeLengthCode;
+    if (pState.mError || !BuildHuffman(lCodeLengthCode, lLengths, 19))
+        return false;
+
+    // Literal/length and distance code lengths share one run-length coded list.
+    int lIndex = 0;
+    while (lIndex < lLengthCount + lDistanceCount)
+    {
+        int lSymbol = DecodeSymbol(pState, lCodeLengthCode);
+        if (lSymbol < 0)
+            return false;
+        if (lSymbol < 16)
+        {
+            lLengths[lIndex++] = (unsigned char)lSymbol;
+            continue;
+        }
+
+        unsigned char lRepeated = 0;
+        int lRun;
+        if (lSymbol == 16)
+        {
+            if (lIndex == 0)
+                return false;
+            lRepeated = lLengths[lIndex - 1];
+            lRun = 3 + (int)ReadBits(pState, 2);
+        }
+        else if (lSymbol == 17)
+        {
+            lRun = 3 + (int)ReadBits(pState, 3);
+        }
+        else
+        {
+            lRun = 11 + (int)ReadBits(pState, 7);
+        }
+        if (pState.mError || lIndex + lRun > lLengthCount + lDistanceCount)
+            return false;
+        while (lRun--)
+            lLengths[lIndex++] = lRepeated;
+    }
+
+    // A block without an end code could never finish.
+    if (lLengths[256] == 0)
+        return false;
+
+    Huffman lLengthCode;
+    Huffman lDistanceCode;
+    if (!BuildHuffman(lLengthCode, lLengths, lLengthCount) ||
+        !BuildHuffman(lDistanceCode, lLengths + lLengthCount, lDistanceCount))
+        return false;
+
+    return InflateCodes(pState, lLengthCode, lDistanceCode);
+}
+
+static unsigned int Adler32(const unsigned char* pData, size_t pSize)
+{
+    // 5552 bytes is the longest run whose sums cannot overflow 32 bits.
+    unsigned int lA = 1;
+    unsigned int lB = 0;
+    while (pSize > 0)
+    {
+        size_t lBlock = pSize < 5552 ? pSize : 5552;
+        pSize -= lBlock;
+        while (lBlock--)
+        {
+            lA += *pData++;
+            lB += lA;
+        }
+        lA %= 65521;
+        lB %= 65521;
+    }
+    return (lB << 16) | lA;
+}
+
+bool InflateZlib(const unsigned char* pData, size_t pSize, unsigned char* pOutput, size_t pOutputSize)
+{
+    // Header: deflate method, window of at most 32 KB, no preset dictionary.
+    if (pSize < 6 || (pData[0] & 0x0F) != 8 || (pData[0] >> 4) > 7 || (pData[1] & 0x20) != 0 ||
+        ((pData[0] << 8) | pData[1]) % 31 != 0)
+        return false;
+
+    InflateState lState;
+    lState.mData = pData;
+    lState.mSize = pSize;
+    lState.mPosition = 2;
+    lState.mBits = 0;
+    lState.mBitCount = 0;
+    lState.mOutput = pOutput;
+    lState.mOutputSize = pOutputSize;
+    lState.mWritten = 0;
+    lState.mError = false;
+
+    bool lLast;
+    do
+    {
+        lLast = ReadBits(lState, 1) != 0;
+        unsigned int lType = ReadBits(lState, 2);
+        if (lState.mError)
+            return false;
+
+        bool lResult;
+        switch (lType)
+        {
+        case 0: lResult = InflateStored(lState); break;
+        case 1: lResult = InflateFixed(lState); break;
+        case 2: lResult = InflateDynamic(lState); break;
+        default: lResult = false; break;
+        }
+        if (!lResult)
+            return false;
+    }
+    while (!lLast);
+
+    // The big endian Adler-32 of the output follows on the next byte boundary.
+    if (lState.mWritten != pOutputSize || lState.mPosition + 4 > pSize)
+        return false;
+    const unsigned char* lChecksum = pData + lState.mPosition;
+    unsigned int lExpected = ((unsigned int)lChecksum[0] << 24) | (lChecksum[1] << 16) | (lChecksum[2] << 8) | lChecksum[3];
+    return lExpected == Adler32(pOutput, pOutputSize);
+}
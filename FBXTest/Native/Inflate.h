@@ -0,0 +1,23 @@
+#ifndef _INFLATE_H
+#define _INFLATE_H
+
+#include <stddef.h>
+
+/** Decompress a zlib stream (RFC 1950/1951), as used for compressed arrays in
+  * binary FBX files, into a buffer of known size.
+  *
+  * FBX array headers store the decoded element count, so the output size is
+  * always known up front and no growable buffer is needed. This is a small
+  * bit-at-a-time decoder rather than a full zlib; it is only used for the few
+  * arrays the native passes rewrite.
+  *
+  * /param pData The compressed stream, starting with the two byte zlib header.
+  * /param pSize Size of the compressed stream in bytes.
+  * /param pOutput Receives the decompressed bytes.
+  * /param pOutputSize Expected decompressed size.
+  * /return false if the stream is malformed, its checksum does not match or it
+  *         does not decode to exactly pOutputSize bytes.
+  */
+bool InflateZlib(const unsigned char* pData, size_t pSize, unsigned char* pOutput, size_t pOutputSize);
+
+#endif // #ifndef _INFLATE_H
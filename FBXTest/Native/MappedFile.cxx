@@ -0,0 +1,104 @@
+#include "MappedFile.h"
+
+#if defined(_WIN32)
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+MappedFile::MappedFile()
+    : mData(NULL)
+    , mSize(0)
+    , mWritable(false)
+#if defined(_WIN32)
+    , mFile(INVALID_HANDLE_VALUE)
+    , mMapping(NULL)
+#else
+    , mFile(-1)
+#endif
+{
+}
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+bool MappedFile::Open(const char* pFileName, bool pWritable)
+{
+    Close();
+
+#if defined(_WIN32)
+    DWORD lAccess = pWritable ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ;
+    mFile = CreateFileA(pFileName, lAccess, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (mFile == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER lSize;
+    if (!GetFileSizeEx(mFile, &lSize) || lSize.QuadPart == 0)
+    {
+        Close();
+        return false;
+    }
+    mSize = (size_t)lSize.QuadPart;
+
+    mMapping = CreateFileMappingA(mFile, NULL, pWritable ? PAGE_READWRITE : PAGE_READONLY, 0, 0, NULL);
+    if (!mMapping)
+    {
+        Close();
+        return false;
+    }
+
+    mData = (unsigned char*)MapViewOfFile(mMapping, pWritable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0);
+#else
+    mFile = open(pFileName, pWritable ? O_RDWR : O_RDONLY);
+    if (mFile < 0)
+        return false;
+
+    struct stat lStat;
+    if (fstat(mFile, &lStat) != 0 || lStat.st_size == 0)
+    {
+        Close();
+        return false;
+    }
+    mSize = (size_t)lStat.st_size;
+
+    void* lData = pWritable ? mmap(NULL, mSize, PROT_READ | PROT_WRITE, MAP_SHARED, mFile, 0)
+                            : mmap(NULL, mSize, PROT_READ, MAP_PRIVATE, mFile, 0);
+    mData = lData == MAP_FAILED ? NULL : (unsigned char*)lData;
+#endif
+
+    if (!mData)
+    {
+        Close();
+        return false;
+    }
+    mWritable = pWritable;
+    return true;
+}
+
+void MappedFile::Close()
+{
+#if defined(_WIN32)
+    if (mData)
+        UnmapViewOfFile(mData);
+    if (mMapping)
+        CloseHandle(mMapping);
+    if (mFile != INVALID_HANDLE_VALUE)
+        CloseHandle(mFile);
+    mMapping = NULL;
+    mFile = INVALID_HANDLE_VALUE;
+#else
+    if (mData)
+        munmap(mData, mSize);
+    if (mFile >= 0)
+        close(mFile);
+    mFile = -1;
+#endif
+    mData = NULL;
+    mSize = 0;
+    mWritable = false;
+}
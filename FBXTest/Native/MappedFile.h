@@ -0,0 +1,43 @@
+#ifndef _MAPPED_FILE_H
+#define _MAPPED_FILE_H
+
+#include <cstddef>
+
+/** Memory mapping of a whole file. The mapping lives until Close() or
+  * destruction, and every pointer handed out by readers built on top of it
+  * points straight into the mapped pages.
+  */
+class MappedFile
+{
+public:
+    MappedFile();
+    ~MappedFile();
+
+    /** Map a file.
+      * /param pFileName The file to map.
+      * /param pWritable Map shared and writable, so stores go straight to the file.
+      * /return false if the file could not be opened or mapped.
+      */
+    bool Open(const char* pFileName, bool pWritable = false);
+    void Close();
+
+    const unsigned char* GetData() const { return mData; }
+    unsigned char* GetWritableData() const { return mWritable ? mData : NULL; }
+    size_t GetSize() const { return mSize; }
+
+private:
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+
+    unsigned char* mData;
+    size_t mSize;
+    bool mWritable;
+#if defined(_WIN32)
+    void* mFile;
+    void* mMapping;
+#else
+    int mFile;
+#endif
+};
+
+#endif // #ifndef _MAPPED_FILE_H
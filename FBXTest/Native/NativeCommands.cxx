@@ -0,0 +1,95 @@
+#include "NativeCommands.h"
+#include "NativeFbxReader.h"
+#include "../Common/Log.h"
+
+#include <cstdio>
+
+bool ListSkeleton(const char* pFileName, const JointMap& pJointMap)
+{
+    NativeFbxReader lReader;
+    if (!lReader.Open(pFileName))
+    {
+        LOG_ERROR("Error: %s: %s\n", pFileName, lReader.GetError().c_str());
+        return false;
+    }
+
+    const std::vector<NativeModel>& lModels = lReader.GetModels();
+    printf("File: %s (FBX %u, %d records, %d models, %d connections)\n\n", pFileName, lReader.GetVersion(),
+           (int)lReader.GetRecords().size(), (int)lModels.size(), (int)lReader.GetConnections().size());
+
+    // Children lists in file order, then an iterative depth first walk.
+    std::vector<int> lFirstChild(lModels.size(), -1);
+    std::vector<int> lNextSibling(lModels.size(), -1);
+    for (int i = (int)lModels.size() - 1; i >= 0; --i)
+    {
+        int lParent = lModels[i].mParent;
+        if (lParent >= 0)
+        {
+            lNextSibling[i] = lFirstChild[lParent];
+            lFirstChild[lParent] = i;
+        }
+    }
+
+    // Roots in file order first. A corrupt file can connect models in a cycle,
+    // which no root reaches; those are listed afterwards from their first model.
+    // Every model is visited at most once.
+    std::vector<int> lRoots;
+    for (int i = 0; i < (int)lModels.size(); ++i)
+    {
+        if (lModels[i].mParent < 0)
+            lRoots.push_back(i);
+    }
+    for (int i = 0; i < (int)lModels.size(); ++i)
+    {
+        if (lModels[i].mParent >= 0)
+            lRoots.push_back(i);
+    }
+
+    int lJoints = 0;
+    int lMapped = 0;
+    int lCyclic = 0;
+    std::vector<bool> lVisited(lModels.size(), false);
+    std::vector<std::pair<int, int> > lStack;
+    for (size_t r = 0; r < lRoots.size(); ++r)
+    {
+        if (lVisited[lRoots[r]])
+            continue;
+        if (lModels[lRoots[r]].mParent >= 0)
+            ++lCyclic;
+        lStack.push_back(std::make_pair(lRoots[r], 0));
+
+        while (!lStack.empty())
+        {
+            int lModel = lStack.back().first;
+            int lDepth = lStack.back().second;
+            lStack.pop_back();
+            if (lVisited[lModel])
+                continue;
+            lVisited[lModel] = true;
+
+            const NativeModel& lInfo = lModels[lModel];
+            if (lInfo.IsSkeleton())
+            {
+                ++lJoints;
+                const char* lNewName = pJointMap.Find(lInfo.mName.mData, lInfo.mName.mLength);
+                if (lNewName)
+                    ++lMapped;
+
+                printf("%*s%.*s [%.*s]%s%s\n", lDepth * 4, "", (int)lInfo.mName.mLength, lInfo.mName.mData,
+                       (int)lInfo.mType.mLength, lInfo.mType.mData, lNewName ? " -> " : "", lNewName ? lNewName : "");
+            }
+
+            // Push in reverse so children come out in file order.
+            std::vector<int> lChildren;
+            for (int c = lFirstChild[lModel]; c >= 0; c = lNextSibling[c])
+                lChildren.push_back(c);
+            for (size_t c = lChildren.size(); c > 0; --c)
+                lStack.push_back(std::make_pair(lChildren[c - 1], lDepth + 1));
+        }
+    }
+
+    printf("\n%d joints, %d would be renamed\n", lJoints, lMapped);
+    if (lCyclic > 0)
+        LOG_WARNING("Warning: %s: %d parent cycles in the model connections\n", pFileName, lCyclic);
+    return true;
+}
@@ -0,0 +1,12 @@
+#ifndef _NATIVE_COMMANDS_H
+#define _NATIVE_COMMANDS_H
+
+#include "../JointMap.h"
+
+/** Print the skeleton hierarchy of a binary FBX file and the new name each joint
+  * would get from pJointMap, using only the native reader (no SDK import).
+  * /return false if the file could not be read or is malformed.
+  */
+bool ListSkeleton(const char* pFileName, const JointMap& pJointMap);
+
+#endif // #ifndef _NATIVE_COMMANDS_H
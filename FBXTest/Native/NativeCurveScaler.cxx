@@ -0,0 +1,213 @@
+#include "NativeCurveScaler.h"
+#include "Inflate.h"
+#include "../Common/Log.h"
+#include "../Common/ScaleKernel.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+static bool ContainsId(const std::vector<long long>& pIds, long long pId)
+{
+    return std::binary_search(pIds.begin(), pIds.end(), pId);
+}
+
+static int FindRecordById(const std::vector<std::pair<long long, int> >& pRecords, long long pId)
+{
+    std::vector<std::pair<long long, int> >::const_iterator it =
+        std::lower_bound(pRecords.begin(), pRecords.end(), std::make_pair(pId, -1));
+    if (it != pRecords.end() && it->first == pId)
+        return it->second;
+    return -1;
+}
+
+static void ScaleDouble(const NativeFbxReader& pReader, int pRecord, size_t pOffset, double pFactor, NativePatchPlan& pPlan)
+{
+    double lValue;
+    memcpy(&lValue, pReader.GetData() + pOffset, sizeof(lValue));
+    lValue *= pFactor;
+    memcpy(pPlan.Replace(pRecord, pOffset, sizeof(lValue), sizeof(lValue)), &lValue, sizeof(lValue));
+}
+
+// Scale the D payloads of every P record in pRecord's Properties70 whose name
+// passes pMatch, starting at value index 4 (after name, type, label and flags).
+template <class Match>
+static int PlanProperties(const NativeFbxReader& pReader, int pRecord, Match pMatch, double pFactor, NativePatchPlan& pPlan)
+{
+    int lMatched = 0;
+    std::vector<NativeProperty> lProperties;
+    int lProperties70 = pReader.FindChild(pRecord, "Properties70");
+    if (lProperties70 < 0)
+        return 0;
+
+    const std::vector<NativeRecord>& lRecords = pReader.GetRecords();
+    for (int lChild = lRecords[lProperties70].mFirstChild; lChild >= 0; lChild = lRecords[lChild].mNextSibling)
+    {
+        if (!lRecords[lChild].mName.Equals("P") || !pReader.GetProperties(lChild, lProperties) ||
+            lProperties.size() < 5 || lProperties[0].mType != 'S' || !pMatch(lProperties[0].mString))
+            continue;
+
+        for (size_t i = 4; i < lProperties.size(); ++i)
+        {
+            if (lProperties[i].mType == 'D')
+                ScaleDouble(pReader, lChild, lProperties[i].mDataOffset, pFactor, pPlan);
+        }
+        ++lMatched;
+    }
+    return lMatched;
+}
+
+static bool IsTranslationProperty(const StringView& pName)
+{
+    return pName.Equals("Lcl Translation");
+}
+
+static bool IsChannelProperty(const StringView& pName)
+{
+    return pName.Equals("d|X") || pName.Equals("d|Y") || pName.Equals("d|Z");
+}
+
+// Scale a float key array. Compressed arrays are inflated and written back
+// uncompressed, which changes the size of the record.
+static bool ScaleArray(const NativeFbxReader& pReader, int pRecord, const NativeProperty& pProperty, bool pAttributes,
+                       double pFactor, NativePatchPlan& pPlan)
+{
+    const size_t lSize = (size_t)pProperty.mArrayLength * 4;
+    unsigned char* lData;
+    if (pProperty.mEncoding == 0)
+    {
+        if (pProperty.mDataSize != lSize)
+            return false;
+        lData = pPlan.Replace(pRecord, pProperty.mDataOffset, lSize, lSize);
+        memcpy(lData, pReader.GetData() + pProperty.mDataOffset, lSize);
+    }
+    else if (pProperty.mEncoding == 1)
+    {
+        // Replace the encoding, the stored length and the payload.
+        unsigned int lHeader[2] = { 0, (unsigned int)lSize };
+        unsigned char* lReplacement = pPlan.Replace(pRecord, pProperty.mOffset + 5, sizeof(lHeader) + pProperty.mDataSize,
+                                                    sizeof(lHeader) + lSize);
+        memcpy(lReplacement, lHeader, sizeof(lHeader));
+        lData = lReplacement + sizeof(lHeader);
+        if (!InflateZlib(pReader.GetData() + pProperty.mDataOffset, pProperty.mDataSize, lData, lSize))
+            return false;
+    }
+    else
+    {
+        return false;
+    }
+
+    if (pAttributes)
+        ScaleKeyAttributeSlopes(lData, pProperty.mArrayLength / 4, (float)pFactor);
+    else
+        ScaleFloatArray(lData, pProperty.mArrayLength, (float)pFactor);
+    return true;
+}
+
+static bool PlanCurve(const NativeFbxReader& pReader, int pRecord, double pFactor, NativePatchPlan& pPlan,
+                      NativeScaleResult& pResult, const char* pFileName)
+{
+    std::vector<NativeProperty> lProperties;
+    const std::vector<NativeRecord>& lRecords = pReader.GetRecords();
+    for (int lChild = lRecords[pRecord].mFirstChild; lChild >= 0; lChild = lRecords[lChild].mNextSibling)
+    {
+        const StringView& lName = lRecords[lChild].mName;
+        const bool lValues = lName.Equals("KeyValueFloat");
+        const bool lAttributes = lName.Equals("KeyAttrDataFloat");
+        if (!lValues && !lAttributes && !lName.Equals("Default"))
+            continue;
+        if (!pReader.GetProperties(lChild, lProperties) || lProperties.empty())
+            continue;
+
+        const NativeProperty& lProperty = lProperties[0];
+        if (lProperty.mType == 'D')
+        {
+            ScaleDouble(pReader, lChild, lProperty.mDataOffset, pFactor, pPlan);
+            continue;
+        }
+        if (!lValues && !lAttributes)
+            continue;
+
+        if (lProperty.mType != 'f')
+        {
+            LOG_ERROR("Error: %s: animation curve at offset %llu has a non-float key array\n",
+                      pFileName, (unsigned long long)lRecords[pRecord].mOffset);
+            return false;
+        }
+        if (!ScaleArray(pReader, lChild, lProperty, lAttributes, pFactor, pPlan))
+        {
+            LOG_ERROR("Error: %s: animation curve at offset %llu has a malformed key array\n",
+                      pFileName, (unsigned long long)lRecords[pRecord].mOffset);
+            return false;
+        }
+        if (lProperty.mEncoding != 0)
+            ++pResult.mInflated;
+        if (lValues)
+            pResult.mKeys += lProperty.mArrayLength;
+    }
+    return true;
+}
+
+bool PlanNativeTranslations(const NativeFbxReader& pReader, double pFactor, NativePatchPlan& pPlan, NativeScaleResult& pResult,
+                            const char* pFileName)
+{
+    // Index curve nodes and curves by object id.
+    std::vector<std::pair<long long, int> > lCurveNodes;
+    std::vector<std::pair<long long, int> > lCurves;
+    std::vector<NativeProperty> lProperties;
+    const std::vector<NativeRecord>& lRecords = pReader.GetRecords();
+    int lObjects = pReader.FindChild(-1, "Objects");
+    for (int lChild = lObjects >= 0 ? lRecords[lObjects].mFirstChild : -1; lChild >= 0; lChild = lRecords[lChild].mNextSibling)
+    {
+        const bool lIsNode = lRecords[lChild].mName.Equals("AnimationCurveNode");
+        if (!lIsNode && !lRecords[lChild].mName.Equals("AnimationCurve"))
+            continue;
+        if (!pReader.GetProperties(lChild, lProperties) || lProperties.empty() || lProperties[0].mType != 'L')
+            continue;
+        (lIsNode ? lCurveNodes : lCurves).push_back(std::make_pair(lProperties[0].mInteger, lChild));
+    }
+    std::sort(lCurveNodes.begin(), lCurveNodes.end());
+    std::sort(lCurves.begin(), lCurves.end());
+
+    // Curve nodes driving a model's Lcl Translation, then the curves feeding them.
+    const std::vector<NativeConnection>& lConnections = pReader.GetConnections();
+    std::vector<long long> lTranslationNodes;
+    for (size_t i = 0; i < lConnections.size(); ++i)
+    {
+        if (lConnections[i].mKind.Equals("OP") && lConnections[i].mProperty.Equals("Lcl Translation") &&
+            FindRecordById(lCurveNodes, lConnections[i].mChild) >= 0)
+            lTranslationNodes.push_back(lConnections[i].mChild);
+    }
+    std::sort(lTranslationNodes.begin(), lTranslationNodes.end());
+    lTranslationNodes.erase(std::unique(lTranslationNodes.begin(), lTranslationNodes.end()), lTranslationNodes.end());
+
+    std::vector<int> lTranslationCurves;
+    for (size_t i = 0; i < lConnections.size(); ++i)
+    {
+        if (!lConnections[i].mKind.Equals("OP") || !ContainsId(lTranslationNodes, lConnections[i].mParent))
+            continue;
+        int lCurve = FindRecordById(lCurves, lConnections[i].mChild);
+        if (lCurve >= 0)
+            lTranslationCurves.push_back(lCurve);
+    }
+    std::sort(lTranslationCurves.begin(), lTranslationCurves.end());
+    lTranslationCurves.erase(std::unique(lTranslationCurves.begin(), lTranslationCurves.end()), lTranslationCurves.end());
+
+    const std::vector<NativeModel>& lModels = pReader.GetModels();
+    for (size_t i = 0; i < lModels.size(); ++i)
+    {
+        pResult.mModels += PlanProperties(pReader, lModels[i].mRecord, IsTranslationProperty, pFactor, pPlan);
+    }
+    for (size_t i = 0; i < lTranslationNodes.size(); ++i)
+    {
+        PlanProperties(pReader, FindRecordById(lCurveNodes, lTranslationNodes[i]), IsChannelProperty, pFactor, pPlan);
+        ++pResult.mCurveNodes;
+    }
+    for (size_t i = 0; i < lTranslationCurves.size(); ++i)
+    {
+        if (!PlanCurve(pReader, lTranslationCurves[i], pFactor, pPlan, pResult, pFileName))
+            return false;
+        ++pResult.mCurves;
+    }
+    return true;
+}
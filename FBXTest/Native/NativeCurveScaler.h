@@ -0,0 +1,40 @@
+#ifndef _NATIVE_CURVE_SCALER_H
+#define _NATIVE_CURVE_SCALER_H
+
+#include "NativePatch.h"
+
+struct NativeScaleResult
+{
+    NativeScaleResult() : mModels(0), mCurveNodes(0), mCurves(0), mKeys(0), mInflated(0) {}
+
+    int mModels;
+    int mCurveNodes;
+    int mCurves;
+    long long mKeys;
+    int mInflated;
+};
+
+/** Add patches to pPlan that multiply every translation in a binary FBX file by pFactor.
+  *
+  * This covers the Lcl Translation of every model, the defaults of translation
+  * curve nodes, and the values, tangents and defaults of their animation curves.
+  * Key arrays are scaled with the SIMD kernels in ScaleKernel.h. Uncompressed
+  * arrays keep their size, so a file without compressed arrays can still be
+  * patched in place. zlib compressed arrays, which the SDK writes for long
+  * curves by default, are inflated and written back uncompressed.
+  *
+  * Everything is read and checked here, before anything is written, so a
+  * rejected file is never left half converted. Geometry, cluster matrices and
+  * limb sizes are not scaled.
+  *
+  * /param pReader The indexed file.
+  * /param pFactor Scale applied to all translations.
+  * /param pPlan Receives the patches.
+  * /param pResult Receives statistics.
+  * /param pFileName Used in error messages.
+  * /return false on malformed or non-float key arrays.
+  */
+bool PlanNativeTranslations(const NativeFbxReader& pReader, double pFactor, NativePatchPlan& pPlan, NativeScaleResult& pResult,
+                            const char* pFileName);
+
+#endif // #ifndef _NATIVE_CURVE_SCALER_H
@@ -0,0 +1,333 @@
+#include "NativeFbxReader.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+static const char BINARY_MAGIC[] = "Kaydara FBX Binary  ";
+static const size_t BINARY_HEADER_SIZE = 27;
+
+template <class T>
+static T ReadLE(const unsigned char* pData)
+{
+    // FBX is little endian, as are all platforms this tool is built for.
+    T lValue;
+    memcpy(&lValue, pData, sizeof(T));
+    return lValue;
+}
+
+bool StringView::Equals(const char* pString) const
+{
+    size_t lLength = strlen(pString);
+    return lLength == mLength && memcmp(mData, pString, lLength) == 0;
+}
+
+NativeFbxReader::NativeFbxReader()
+    : mData(NULL)
+    , mSize(0)
+    , mFooterOffset(0)
+    , mVersion(0)
+{
+}
+
+bool NativeFbxReader::Open(const char* pFileName)
+{
+    if (!mFile.Open(pFileName))
+    {
+        mError = std::string("Unable to map ") + pFileName;
+        return false;
+    }
+    return Parse(mFile.GetData(), mFile.GetSize());
+}
+
+bool NativeFbxReader::Parse(const unsigned char* pData, size_t pSize)
+{
+    mData = pData;
+    mSize = pSize;
+    mFooterOffset = 0;
+    mVersion = 0;
+    mError.clear();
+    mRecords.clear();
+    mModels.clear();
+    mConnections.clear();
+    mModelIds.clear();
+
+    if (mSize < BINARY_HEADER_SIZE || memcmp(mData, BINARY_MAGIC, sizeof(BINARY_MAGIC)) != 0)
+        return Fail("Not a binary FBX file", 0);
+
+    mVersion = ReadLE<unsigned int>(mData + 23);
+    if (mVersion < 7000)
+        return Fail("Only FBX 7.x binary files are supported", 23);
+
+    return IndexRecords() && IndexObjects();
+}
+
+bool NativeFbxReader::Fail(const char* pMessage, size_t pOffset)
+{
+    char lBuffer[256];
+    sprintf(lBuffer, "%s (offset %llu)", pMessage, (unsigned long long)pOffset);
+    mError = lBuffer;
+    return false;
+}
+
+bool NativeFbxReader::IndexRecords()
+{
+    const bool lWide = mVersion >= 7500;
+    const size_t lHeaderSize = GetHeaderSize();
+
+    // Walk the tree iteratively. Each stack entry is the record whose children are
+    // being read and the end of its range; -1 is the implicit top-level list.
+    std::vector<std::pair<int, size_t> > lStack;
+    lStack.push_back(std::make_pair(-1, mSize));
+    std::vector<int> lLastChild(1, -1);
+
+    size_t lOffset = BINARY_HEADER_SIZE;
+    while (!lStack.empty())
+    {
+        const int lParent = lStack.back().first;
+        const size_t lLimit = lStack.back().second;
+
+        if (lOffset + lHeaderSize > lLimit)
+        {
+            if (lParent == -1)
+                return Fail("Truncated top-level record list", lOffset);
+            return Fail("Record children overflow their parent", lOffset);
+        }
+
+        const unsigned char* lHeader = mData + lOffset;
+        NativeRecord lRecord;
+        unsigned long long lEndOffset;
+        unsigned long long lPropertyListLength;
+        if (lWide)
+        {
+            lEndOffset = ReadLE<unsigned long long>(lHeader);
+            lRecord.mPropertyCount = (unsigned int)ReadLE<unsigned long long>(lHeader + 8);
+            lPropertyListLength = ReadLE<unsigned long long>(lHeader + 16);
+        }
+        else
+        {
+            lEndOffset = ReadLE<unsigned int>(lHeader);
+            lRecord.mPropertyCount = ReadLE<unsigned int>(lHeader + 4);
+            lPropertyListLength = ReadLE<unsigned int>(lHeader + 8);
+        }
+        unsigned char lNameLength = lHeader[lHeaderSize - 1];
+
+        if (lEndOffset == 0)
+        {
+            // Null record: end of the current child list.
+            lOffset += lHeaderSize;
+            if (lParent != -1 && lOffset != lLimit)
+                return Fail("Null record does not end its parent", lOffset);
+            if (lParent == -1)
+                mFooterOffset = lOffset;
+            lStack.pop_back();
+            lLastChild.pop_back();
+            continue;
+        }
+
+        // Compare in 64 bits and by subtraction, so a corrupt length can neither be
+        // truncated by the cast to size_t nor wrap around the bound checks.
+        const size_t lPropertyOffset = lOffset + lHeaderSize + lNameLength;
+        if (lEndOffset > lLimit || lPropertyOffset > lEndOffset || lPropertyListLength > lEndOffset - lPropertyOffset)
+            return Fail("Record extends past its parent", lOffset);
+
+        lRecord.mOffset = lOffset;
+        lRecord.mEndOffset = (size_t)lEndOffset;
+        lRecord.mName = StringView((const char*)lHeader + lHeaderSize, lNameLength);
+        lRecord.mPropertyOffset = lPropertyOffset;
+        lRecord.mPropertyListLength = (size_t)lPropertyListLength;
+        lRecord.mParent = lParent;
+        lRecord.mFirstChild = -1;
+        lRecord.mNextSibling = -1;
+
+        const int lIndex = (int)mRecords.size();
+        if (lLastChild.back() >= 0)
+            mRecords[lLastChild.back()].mNextSibling = lIndex;
+        else if (lParent >= 0)
+            mRecords[lParent].mFirstChild = lIndex;
+        lLastChild.back() = lIndex;
+        mRecords.push_back(lRecord);
+
+        size_t lChildren = lRecord.mPropertyOffset + lRecord.mPropertyListLength;
+        if (lChildren < lRecord.mEndOffset)
+        {
+            lStack.push_back(std::make_pair(lIndex, lRecord.mEndOffset));
+            lLastChild.push_back(-1);
+            lOffset = lChildren;
+        }
+        else
+        {
+            lOffset = lRecord.mEndOffset;
+        }
+    }
+
+    return true;
+}
+
+bool NativeFbxReader::ReadProperty(size_t& pOffset, size_t pEnd, NativeProperty& pProperty) const
+{
+    if (pOffset >= pEnd)
+        return false;
+
+    const unsigned char* lData = mData + pOffset;
+    pProperty.mType = (char)lData[0];
+    pProperty.mInteger = 0;
+    pProperty.mReal = 0.0;
+    pProperty.mString = StringView();
+    pProperty.mArrayLength = 0;
+    pProperty.mEncoding = 0;
+    pProperty.mOffset = pOffset;
+    pProperty.mDataOffset = pOffset + 1;
+
+    size_t lSize = 0;
+    switch (pProperty.mType)
+    {
+    case 'Y': lSize = 2; break;
+    case 'C': lSize = 1; break;
+    case 'I': case 'F': lSize = 4; break;
+    case 'L': case 'D': lSize = 8; break;
+    case 'S': case 'R':
+        if (pOffset + 5 > pEnd)
+            return false;
+        lSize = ReadLE<unsigned int>(lData + 1);
+        pProperty.mDataOffset = pOffset + 5;
+        break;
+    case 'f': case 'd': case 'l': case 'i': case 'b':
+        if (pOffset + 13 > pEnd)
+            return false;
+        pProperty.mArrayLength = ReadLE<unsigned int>(lData + 1);
+        pProperty.mEncoding = ReadLE<unsigned int>(lData + 5);
+        lSize = ReadLE<unsigned int>(lData + 9);
+        pProperty.mDataOffset = pOffset + 13;
+        break;
+    default:
+        return false;
+    }
+
+    // The data offset is at most pEnd here; subtracting cannot wrap for any stored size.
+    if (lSize > pEnd - pProperty.mDataOffset)
+        return false;
+    pProperty.mDataSize = lSize;
+
+    const unsigned char* lPayload = mData + pProperty.mDataOffset;
+    switch (pProperty.mType)
+    {
+    case 'Y': pProperty.mInteger = ReadLE<short>(lPayload); break;
+    case 'C': pProperty.mInteger = lPayload[0]; break;
+    case 'I': pProperty.mInteger = ReadLE<int>(lPayload); break;
+    case 'L': pProperty.mInteger = ReadLE<long long>(lPayload); break;
+    case 'F': pProperty.mReal = ReadLE<float>(lPayload); break;
+    case 'D': pProperty.mReal = ReadLE<double>(lPayload); break;
+    case 'S': case 'R': pProperty.mString = StringView((const char*)lPayload, lSize); break;
+    default: break;
+    }
+
+    pOffset = pProperty.mDataOffset + lSize;
+    return true;
+}
+
+bool NativeFbxReader::GetProperties(int pRecord, std::vector<NativeProperty>& pProperties) const
+{
+    pProperties.clear();
+    const NativeRecord& lRecord = mRecords[pRecord];
+    size_t lOffset = lRecord.mPropertyOffset;
+    size_t lEnd = lRecord.mPropertyOffset + lRecord.mPropertyListLength;
+
+    for (unsigned int i = 0; i < lRecord.mPropertyCount; ++i)
+    {
+        NativeProperty lProperty;
+        if (!ReadProperty(lOffset, lEnd, lProperty))
+            return false;
+        pProperties.push_back(lProperty);
+    }
+    return lOffset == lEnd;
+}
+
+int NativeFbxReader::FindChild(int pParent, const char* pName) const
+{
+    int lChild = pParent >= 0 ? mRecords[pParent].mFirstChild : (mRecords.empty() ? -1 : 0);
+    for (; lChild >= 0; lChild = mRecords[lChild].mNextSibling)
+    {
+        if (mRecords[lChild].mName.Equals(pName))
+            return lChild;
+    }
+    return -1;
+}
+
+int NativeFbxReader::FindModel(long long pId) const
+{
+    std::vector<std::pair<long long, int> >::const_iterator it =
+        std::lower_bound(mModelIds.begin(), mModelIds.end(), std::make_pair(pId, -1));
+    if (it != mModelIds.end() && it->first == pId)
+        return it->second;
+    return -1;
+}
+
+bool NativeFbxReader::IndexObjects()
+{
+    std::vector<NativeProperty> lProperties;
+
+    int lObjects = FindChild(-1, "Objects");
+    if (lObjects >= 0)
+    {
+        for (int lChild = mRecords[lObjects].mFirstChild; lChild >= 0; lChild = mRecords[lChild].mNextSibling)
+        {
+            if (!mRecords[lChild].mName.Equals("Model"))
+                continue;
+
+            if (!GetProperties(lChild, lProperties) || lProperties.size() < 3 ||
+                lProperties[0].mType != 'L' || lProperties[1].mType != 'S' || lProperties[2].mType != 'S')
+                return Fail("Malformed Model record", mRecords[lChild].mOffset);
+
+            NativeModel lModel;
+            lModel.mId = lProperties[0].mInteger;
+            lModel.mName = lProperties[1].mString;
+            lModel.mType = lProperties[2].mString;
+            lModel.mRecord = lChild;
+            lModel.mParent = -1;
+
+            // Binary names are stored as "Name\x00\x01Class".
+            const void* lSeparator = memchr(lModel.mName.mData, 0, lModel.mName.mLength);
+            if (lSeparator)
+                lModel.mName.mLength = (const char*)lSeparator - lModel.mName.mData;
+
+            mModelIds.push_back(std::make_pair(lModel.mId, (int)mModels.size()));
+            mModels.push_back(lModel);
+        }
+    }
+    std::sort(mModelIds.begin(), mModelIds.end());
+
+    int lConnectionsRecord = FindChild(-1, "Connections");
+    if (lConnectionsRecord >= 0)
+    {
+        for (int lChild = mRecords[lConnectionsRecord].mFirstChild; lChild >= 0; lChild = mRecords[lChild].mNextSibling)
+        {
+            if (!mRecords[lChild].mName.Equals("C"))
+                continue;
+
+            if (!GetProperties(lChild, lProperties) || lProperties.size() < 3 ||
+                lProperties[0].mType != 'S' || lProperties[1].mType != 'L' || lProperties[2].mType != 'L')
+                return Fail("Malformed connection record", mRecords[lChild].mOffset);
+
+            NativeConnection lConnection;
+            lConnection.mKind = lProperties[0].mString;
+            lConnection.mChild = lProperties[1].mInteger;
+            lConnection.mParent = lProperties[2].mInteger;
+            if (lProperties.size() > 3 && lProperties[3].mType == 'S')
+                lConnection.mProperty = lProperties[3].mString;
+            lConnection.mRecord = lChild;
+            mConnections.push_back(lConnection);
+
+            // Model to model object connections form the node hierarchy.
+            if (lConnection.mKind.Equals("OO"))
+            {
+                int lChildModel = FindModel(lConnection.mChild);
+                int lParentModel = FindModel(lConnection.mParent);
+                if (lChildModel >= 0 && lParentModel >= 0)
+                    mModels[lChildModel].mParent = lParentModel;
+            }
+        }
+    }
+
+    return true;
+}
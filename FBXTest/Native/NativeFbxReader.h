@@ -0,0 +1,139 @@
+#ifndef _NATIVE_FBX_READER_H
+#define _NATIVE_FBX_READER_H
+
+#include "MappedFile.h"
+
+#include <string>
+#include <vector>
+
+/** Non-owning view of a string inside the parsed file. Not NUL terminated. */
+struct StringView
+{
+    StringView() : mData(NULL), mLength(0) {}
+    StringView(const char* pData, size_t pLength) : mData(pData), mLength(pLength) {}
+
+    bool Equals(const char* pString) const;
+    std::string ToString() const { return std::string(mData, mLength); }
+
+    const char* mData;
+    size_t mLength;
+};
+
+/** One property of a node record. Scalars are decoded into mInteger or mReal;
+  * strings, raw blobs and arrays point into the file.
+  */
+struct NativeProperty
+{
+    char mType;             // FBX type code: Y C I F D L S R f d l i b
+    long long mInteger;     // Y, C, I, L
+    double mReal;           // F, D
+    StringView mString;     // S, R
+    unsigned int mArrayLength;
+    unsigned int mEncoding; // 0 = raw, 1 = zlib
+    size_t mOffset;         // Offset of the type code in the file.
+    size_t mDataOffset;     // Offset of the payload (string bytes or array data).
+    size_t mDataSize;       // Size of the payload in bytes, as stored.
+};
+
+/** One node record. Children form a tree through mFirstChild/mNextSibling. */
+struct NativeRecord
+{
+    StringView mName;
+    size_t mOffset;             // Start of the record header.
+    size_t mEndOffset;          // Absolute offset just past the record, as stored in the file.
+    size_t mPropertyOffset;     // Start of the property list.
+    size_t mPropertyListLength;
+    unsigned int mPropertyCount;
+    int mParent;
+    int mFirstChild;
+    int mNextSibling;
+};
+
+/** A Model object (skeleton joint, mesh node, null, ...). */
+struct NativeModel
+{
+    long long mId;
+    StringView mName;       // Joint name without the "\x00\x01Model" class suffix.
+    StringView mType;       // "LimbNode", "Root", "Limb", "Mesh", "Null", ...
+    int mRecord;
+    int mParent;            // Index of the parent model, -1 for scene root children. Corrupt files may form cycles.
+
+    bool IsSkeleton() const { return mType.Equals("LimbNode") || mType.Equals("Root") || mType.Equals("Limb"); }
+};
+
+/** A "C" record of the Connections section. */
+struct NativeConnection
+{
+    StringView mKind;       // "OO" or "OP"
+    long long mChild;
+    long long mParent;
+    StringView mProperty;   // Only for "OP" connections.
+    int mRecord;
+};
+
+/** Standalone reader for binary FBX 7.x files.
+  *
+  * The file is memory mapped and scanned once, following the stored end offsets,
+  * to build an index of every node record without decoding property payloads
+  * or inflating compressed arrays. Models and connections are then resolved
+  * into a skeleton hierarchy. All names are views into the mapping, so nothing
+  * is copied and the reader must outlive any view taken from it.
+  *
+  * This does not depend on the FBX SDK and is far cheaper than FbxImporter::Import
+  * when only the node structure and names are needed.
+  */
+class NativeFbxReader
+{
+public:
+    NativeFbxReader();
+
+    /** Map and index a file. On failure GetError() describes the problem. */
+    bool Open(const char* pFileName);
+
+    /** Index a file already in memory. pData must stay valid while the reader is used. */
+    bool Parse(const unsigned char* pData, size_t pSize);
+
+    const std::string& GetError() const { return mError; }
+    unsigned int GetVersion() const { return mVersion; }
+    const unsigned char* GetData() const { return mData; }
+    size_t GetSize() const { return mSize; }
+
+    /** Offset just past the top-level null record, where the file footer starts. */
+    size_t GetFooterOffset() const { return mFooterOffset; }
+
+    const std::vector<NativeRecord>& GetRecords() const { return mRecords; }
+    const std::vector<NativeModel>& GetModels() const { return mModels; }
+    const std::vector<NativeConnection>& GetConnections() const { return mConnections; }
+
+    /** Index of the first child of pParent named pName, -1 if none. pParent -1 searches top-level records. */
+    int FindChild(int pParent, const char* pName) const;
+
+    /** Decode all properties of a record. */
+    bool GetProperties(int pRecord, std::vector<NativeProperty>& pProperties) const;
+
+    /** Index of the model with the given object id, -1 if none. */
+    int FindModel(long long pId) const;
+
+    /** Size of a record header for this file version, excluding the name. */
+    size_t GetHeaderSize() const { return mVersion >= 7500 ? 25 : 13; }
+
+private:
+    bool Fail(const char* pMessage, size_t pOffset);
+    bool IndexRecords();
+    bool IndexObjects();
+    bool ReadProperty(size_t& pOffset, size_t pEnd, NativeProperty& pProperty) const;
+
+    MappedFile mFile;
+    const unsigned char* mData;
+    size_t mSize;
+    size_t mFooterOffset;
+    unsigned int mVersion;
+    std::string mError;
+
+    std::vector<NativeRecord> mRecords;
+    std::vector<NativeModel> mModels;
+    std::vector<NativeConnection> mConnections;
+    std::vector<std::pair<long long, int> > mModelIds;  // Sorted by id for FindModel.
+};
+
+#endif // #ifndef _NATIVE_FBX_READER_H
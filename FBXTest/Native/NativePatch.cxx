@@ -0,0 +1,238 @@
+#include "NativePatch.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <map>
+
+// The footer is: footer id (16), zeros (4), alignment padding (0-16), then the fixed
+// tail of version (4), reserved zeros (120) and magic (16).
+static const size_t FOOTER_ID_SIZE = 16;
+static const size_t FOOTER_ZERO_SIZE = 4;
+static const size_t FOOTER_TAIL_SIZE = 140;
+static const size_t WRITE_BUFFER_SIZE = 4 * 1024 * 1024;
+
+// Buffered output that hands large unchanged spans straight to fwrite.
+class SequentialWriter
+{
+public:
+    SequentialWriter() : mFile(NULL), mUsed(0), mWritten(0), mOk(true) {}
+    ~SequentialWriter() { Close(); }
+
+    bool Open(const char* pFileName)
+    {
+        mFile = fopen(pFileName, "wb");
+        mBuffer.resize(WRITE_BUFFER_SIZE);
+        return mFile != NULL;
+    }
+
+    void Write(const void* pData, size_t pSize)
+    {
+        if (mUsed + pSize > mBuffer.size())
+        {
+            Flush();
+            if (pSize >= mBuffer.size())
+            {
+                mOk = mOk && fwrite(pData, 1, pSize, mFile) == pSize;
+                mWritten += pSize;
+                return;
+            }
+        }
+        memcpy(&mBuffer[mUsed], pData, pSize);
+        mUsed += pSize;
+    }
+
+    bool Close()
+    {
+        if (!mFile)
+            return mOk;
+        Flush();
+        mOk = fclose(mFile) == 0 && mOk;
+        mFile = NULL;
+        return mOk;
+    }
+
+    long long GetWritten() const { return mWritten; }
+
+private:
+    void Flush()
+    {
+        if (mUsed)
+        {
+            mOk = mOk && fwrite(&mBuffer[0], 1, mUsed, mFile) == mUsed;
+            mWritten += mUsed;
+            mUsed = 0;
+        }
+    }
+
+    FILE* mFile;
+    std::vector<char> mBuffer;
+    size_t mUsed;
+    long long mWritten;
+    bool mOk;
+};
+
+NativePatchPlan::NativePatchPlan()
+{
+}
+
+unsigned char* NativePatchPlan::Replace(int pRecord, size_t pOffset, size_t pLength, size_t pReplacementLength)
+{
+    Patch lPatch = { pOffset, pLength, mPool.size(), pReplacementLength, pRecord };
+    mEdits.push_back(lPatch);
+    mPool.resize(mPool.size() + pReplacementLength);
+    return pReplacementLength ? &mPool[lPatch.mReplacement] : NULL;
+}
+
+bool NativePatchPlan::ChangesSize() const
+{
+    for (size_t i = 0; i < mEdits.size(); ++i)
+    {
+        if (mEdits[i].mLength != mEdits[i].mReplacementLength)
+            return true;
+    }
+    return false;
+}
+
+void NativePatchPlan::AddPatch(size_t pOffset, size_t pLength, size_t pReplacement, size_t pReplacementLength)
+{
+    Patch lPatch = { pOffset, pLength, pReplacement, pReplacementLength, -1 };
+    mPatches.push_back(lPatch);
+}
+
+void NativePatchPlan::AddOffset(size_t pOffset, unsigned long long pValue, bool pWide)
+{
+    const size_t lSize = pWide ? 8 : 4;
+    const size_t lReplacement = mPool.size();
+    mPool.resize(lReplacement + lSize);
+    if (pWide)
+    {
+        memcpy(&mPool[lReplacement], &pValue, lSize);
+    }
+    else
+    {
+        unsigned int lValue = (unsigned int)pValue;
+        memcpy(&mPool[lReplacement], &lValue, lSize);
+    }
+    AddPatch(pOffset, lSize, lReplacement, lSize);
+}
+
+long long NativePatchPlan::DeltaBefore(size_t pOffset) const
+{
+    Patch lKey = { pOffset, 0, 0, 0, -1 };
+    size_t lCount = std::lower_bound(mEdits.begin(), mEdits.end(), lKey) - mEdits.begin();
+    return mDeltaBefore[lCount];
+}
+
+bool NativePatchPlan::Finish(const NativeFbxReader& pReader)
+{
+    const bool lWide = pReader.GetVersion() >= 7500;
+    const size_t lOffsetSize = lWide ? 8 : 4;
+
+    std::sort(mEdits.begin(), mEdits.end());
+    mPatches = mEdits;
+
+    mDeltaBefore.assign(1, 0);
+    long long lDelta = 0;
+    std::map<int, long long> lRecordDeltas;
+    for (size_t i = 0; i < mEdits.size(); ++i)
+    {
+        long long lEditDelta = (long long)mEdits[i].mReplacementLength - (long long)mEdits[i].mLength;
+        lDelta += lEditDelta;
+        mDeltaBefore.push_back(lDelta);
+        if (lEditDelta != 0)
+            lRecordDeltas[mEdits[i].mRecord] += lEditDelta;
+    }
+    if (lRecordDeltas.empty())
+        return true;
+
+    // Every record that ends after a length change gets a new absolute end offset.
+    const std::vector<NativeRecord>& lRecords = pReader.GetRecords();
+    for (size_t i = 0; i < lRecords.size(); ++i)
+    {
+        long long lRecordDelta = DeltaBefore(lRecords[i].mEndOffset);
+        if (lRecordDelta == 0)
+            continue;
+
+        unsigned long long lEnd = lRecords[i].mEndOffset + lRecordDelta;
+        if (!lWide && lEnd > 0xFFFFFFFFull)
+            return false;
+        AddOffset(lRecords[i].mOffset, lEnd, lWide);
+    }
+
+    // Changed records also get a new property list length.
+    for (std::map<int, long long>::const_iterator it = lRecordDeltas.begin(); it != lRecordDeltas.end(); ++it)
+    {
+        const NativeRecord& lRecord = lRecords[it->first];
+        AddOffset(lRecord.mOffset + 2 * lOffsetSize, lRecord.mPropertyListLength + it->second, lWide);
+    }
+
+    // The footer pads the file so the version field is 16 byte aligned. Recompute
+    // the padding after the 4 zero bytes for the new footer position when the layout
+    // is the standard one; anything else is copied unchanged.
+    const size_t lFooter = pReader.GetFooterOffset();
+    const size_t lSize = pReader.GetSize();
+    static const unsigned char lZeros[FOOTER_ZERO_SIZE] = { 0 };
+    if (lFooter > 0 && lSize >= lFooter + FOOTER_ID_SIZE + FOOTER_ZERO_SIZE + FOOTER_TAIL_SIZE)
+    {
+        size_t lPaddingStart = lFooter + FOOTER_ID_SIZE + FOOTER_ZERO_SIZE;
+        size_t lPadding = lSize - lPaddingStart - FOOTER_TAIL_SIZE;
+        unsigned int lVersion;
+        memcpy(&lVersion, pReader.GetData() + lPaddingStart + lPadding, sizeof(lVersion));
+
+        if (lPadding <= 16 && lVersion == pReader.GetVersion() &&
+            memcmp(pReader.GetData() + lFooter + FOOTER_ID_SIZE, lZeros, FOOTER_ZERO_SIZE) == 0)
+        {
+            size_t lNewStart = (size_t)(lPaddingStart + DeltaBefore(lPaddingStart));
+            size_t lNewPadding = ((lNewStart + 15) & ~(size_t)15) - lNewStart;
+            if (lNewPadding == 0)
+                lNewPadding = 16;
+
+            if (lNewPadding != lPadding)
+            {
+                size_t lReplacement = mPool.size();
+                mPool.resize(lReplacement + lNewPadding, 0);
+                AddPatch(lPaddingStart, lPadding, lReplacement, lNewPadding);
+            }
+        }
+    }
+
+    std::sort(mPatches.begin(), mPatches.end());
+    return true;
+}
+
+bool NativePatchPlan::Write(const NativeFbxReader& pReader, const char* pFileName, long long& pWritten) const
+{
+    SequentialWriter lWriter;
+    if (!lWriter.Open(pFileName))
+        return false;
+
+    const unsigned char* lData = pReader.GetData();
+    size_t lPosition = 0;
+    for (size_t i = 0; i < mPatches.size(); ++i)
+    {
+        const Patch& lPatch = mPatches[i];
+        lWriter.Write(lData + lPosition, lPatch.mOffset - lPosition);
+        if (lPatch.mReplacementLength)
+            lWriter.Write(&mPool[lPatch.mReplacement], lPatch.mReplacementLength);
+        lPosition = lPatch.mOffset + lPatch.mLength;
+    }
+    lWriter.Write(lData + lPosition, pReader.GetSize() - lPosition);
+
+    bool lResult = lWriter.Close();
+    pWritten = lWriter.GetWritten();
+    return lResult;
+}
+
+long long NativePatchPlan::ApplyInPlace(unsigned char* pData) const
+{
+    long long lWritten = 0;
+    for (size_t i = 0; i < mEdits.size(); ++i)
+    {
+        const Patch& lPatch = mEdits[i];
+        if (lPatch.mReplacementLength)
+            memcpy(pData + lPatch.mOffset, &mPool[lPatch.mReplacement], lPatch.mReplacementLength);
+        lWritten += lPatch.mReplacementLength;
+    }
+    return lWritten;
+}
@@ -0,0 +1,71 @@
+#ifndef _NATIVE_PATCH_H
+#define _NATIVE_PATCH_H
+
+#include "NativeFbxReader.h"
+
+#include <vector>
+
+/** Byte range replacements for one binary FBX file, shared by the native passes.
+  *
+  * Each replacement lies inside the property list of one record and may change
+  * its length. Finish() then adds the fix-ups that keep the file valid: the
+  * absolute end offset of every record that ends after a length change, the
+  * property list length of every changed record and the footer alignment
+  * padding. The patched file is written in one forward pass with large
+  * sequential writes, or, when nothing changes size, patched in place.
+  */
+class NativePatchPlan
+{
+public:
+    NativePatchPlan();
+
+    /** Replace pLength bytes at pOffset, inside the property list of pRecord,
+      * with pReplacementLength new bytes.
+      * /return The new bytes, for the caller to fill in. Valid until the next call.
+      */
+    unsigned char* Replace(int pRecord, size_t pOffset, size_t pLength, size_t pReplacementLength);
+
+    bool IsEmpty() const { return mEdits.empty(); }
+
+    /** true if any replacement has a different length than the bytes it replaces. */
+    bool ChangesSize() const;
+
+    /** Add the offset, length and padding fix-ups for the file pReader indexed.
+      * /return false if the patched file would exceed the 4 GB offset limit of FBX 7.4.
+      */
+    bool Finish(const NativeFbxReader& pReader);
+
+    /** Write the patched file. Call Finish() first. */
+    bool Write(const NativeFbxReader& pReader, const char* pFileName, long long& pWritten) const;
+
+    /** Copy the replacements over a writable mapping of the file. Only valid
+      * when nothing changes size.
+      * /return The number of bytes written.
+      */
+    long long ApplyInPlace(unsigned char* pData) const;
+
+private:
+    // Replace mLength bytes at mOffset of the source with mReplacementLength bytes
+    // starting at mReplacement in the pool.
+    struct Patch
+    {
+        size_t mOffset;
+        size_t mLength;
+        size_t mReplacement;
+        size_t mReplacementLength;
+        int mRecord;
+
+        bool operator<(const Patch& pOther) const { return mOffset < pOther.mOffset; }
+    };
+
+    void AddPatch(size_t pOffset, size_t pLength, size_t pReplacement, size_t pReplacementLength);
+    void AddOffset(size_t pOffset, unsigned long long pValue, bool pWide);
+    long long DeltaBefore(size_t pOffset) const;
+
+    std::vector<unsigned char> mPool;
+    std::vector<Patch> mEdits;              // Requested replacements, sorted by Finish().
+    std::vector<long long> mDeltaBefore;    // Length change of the first i edits.
+    std::vector<Patch> mPatches;            // Edits and fix-ups, sorted by offset.
+};
+
+#endif // #ifndef _NATIVE_PATCH_H
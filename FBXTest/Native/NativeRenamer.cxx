@@ -0,0 +1,142 @@
+#include "NativeRenamer.h"
+#include "../Common/Log.h"
+#include "../Common/ScaleKernel.h"
+#include "../RenameReport.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+
+#if defined(_WIN32)
+    #include <process.h>
+    #define NATIVE_PROCESS_ID _getpid()
+#else
+    #include <unistd.h>
+    #define NATIVE_PROCESS_ID getpid()
+#endif
+
+static std::atomic<int> gNextTemporary(0);
+
+/** A name next to pFileName that no other process or thread of this one uses. */
+static std::string GetTemporaryName(const char* pFileName)
+{
+    char lSuffix[32];
+    sprintf(lSuffix, ".%d.%d.tmp", (int)NATIVE_PROCESS_ID, gNextTemporary++);
+    return std::string(pFileName) + lSuffix;
+}
+
+static void ReportJoint(FileReport* pReport, const NativeModel& pModel, const char* pNewName)
+{
+    if (!pReport)
+        return;
+    pReport->BeginJoint(pModel.mName.ToString().c_str());
+    pReport->JointRenamed(pNewName);
+    // Same type names as the SDK pipeline reports.
+    pReport->JointType(pModel.mType.Equals("LimbNode") ? "Limb Node" : pModel.mType.ToString().c_str());
+    pReport->EndJoint();
+}
+
+static int PlanNames(const NativeFbxReader& pReader, const JointMap& pJointMap, NativePatchPlan& pPlan, FileReport* pReport)
+{
+    int lRenamed = 0;
+    std::vector<NativeProperty> lProperties;
+    const std::vector<NativeModel>& lModels = pReader.GetModels();
+    for (size_t i = 0; i < lModels.size(); ++i)
+    {
+        const NativeModel& lModel = lModels[i];
+        if (!lModel.IsSkeleton())
+            continue;
+
+        const char* lNewName = pJointMap.Find(lModel.mName.mData, lModel.mName.mLength);
+        ReportJoint(pReport, lModel, lNewName);
+        if (!lNewName)
+            continue;
+
+        pReader.GetProperties(lModel.mRecord, lProperties);
+        const NativeProperty& lName = lProperties[1];
+
+        // Keep the "\x00\x01Model" class suffix that follows the name.
+        size_t lSuffixLength = lName.mString.mLength - lModel.mName.mLength;
+        size_t lNameLength = strlen(lNewName);
+        unsigned int lNewLength = (unsigned int)(lNameLength + lSuffixLength);
+
+        // Replace the 4 byte length and the string bytes that follow the 'S' type code.
+        unsigned char* lReplacement = pPlan.Replace(lModel.mRecord, lName.mOffset + 1, 4 + lName.mDataSize, 4 + lNewLength);
+        memcpy(lReplacement, &lNewLength, 4);
+        memcpy(lReplacement + 4, lNewName, lNameLength);
+        memcpy(lReplacement + 4 + lNameLength, lName.mString.mData + lModel.mName.mLength, lSuffixLength);
+
+        LOG_TRACE("Renaming %.*s to %s\n", (int)lModel.mName.mLength, lModel.mName.mData, lNewName);
+        ++lRenamed;
+    }
+    return lRenamed;
+}
+
+bool RenameNative(const char* pInput, const char* pOutput, const JointMap& pJointMap, double pScale, NativeRenameResult* pResult,
+                  FileReport* pReport)
+{
+    NativeRenameResult lResult;
+    NativePatchPlan lPlan;
+    const bool lSamePath = strcmp(pInput, pOutput) == 0;
+    const std::string lTarget = lSamePath ? GetTemporaryName(pOutput) : std::string(pOutput);
+
+    {
+        NativeFbxReader lReader;
+        if (!lReader.Open(pInput))
+        {
+            LOG_ERROR("Error: %s: %s\n", pInput, lReader.GetError().c_str());
+            return false;
+        }
+
+        // Plan every change before writing, so a file that cannot be scaled is not left renamed.
+        lResult.mRenamed = PlanNames(lReader, pJointMap, lPlan, pReport);
+        if (pScale != 1.0 && !PlanNativeTranslations(lReader, pScale, lPlan, lResult.mScale, pInput))
+            return false;
+
+        lResult.mInPlace = lSamePath && !lPlan.ChangesSize();
+        if (!lPlan.Finish(lReader))
+        {
+            LOG_ERROR("Error: %s: patched file exceeds the 4 GB offset limit of FBX %u\n", pInput, lReader.GetVersion());
+            return false;
+        }
+
+        if (!lResult.mInPlace && !lPlan.Write(lReader, lTarget.c_str(), lResult.mBytesWritten))
+        {
+            LOG_ERROR("Error: Unable to write %s\n", lTarget.c_str());
+            remove(lTarget.c_str());
+            return false;
+        }
+    }
+
+    if (lResult.mInPlace)
+    {
+        MappedFile lFile;
+        if (!lFile.Open(pInput, true))
+        {
+            LOG_ERROR("Error: Unable to map %s for writing\n", pInput);
+            return false;
+        }
+        lResult.mBytesWritten = lPlan.ApplyInPlace(lFile.GetWritableData());
+    }
+    else if (lSamePath)
+    {
+        // The input mapping is closed now, so the original can be replaced.
+        remove(pOutput);
+        if (rename(lTarget.c_str(), pOutput) != 0)
+        {
+            LOG_ERROR("Error: Unable to replace %s\n", pOutput);
+            return false;
+        }
+    }
+
+    LOG_INFO("Renamed %d joints, %lld bytes written%s\n", lResult.mRenamed, lResult.mBytesWritten, lResult.mInPlace ? " in place" : "");
+    if (pScale != 1.0)
+    {
+        LOG_INFO("Scaled translations by %g: %d models, %d curves, %lld keys, %d arrays inflated (%s)\n",
+                 pScale, lResult.mScale.mModels, lResult.mScale.mCurves, lResult.mScale.mKeys, lResult.mScale.mInflated,
+                 GetScaleKernelName());
+    }
+    if (pResult)
+        *pResult = lResult;
+    return true;
+}
@@ -0,0 +1,46 @@
+#ifndef _NATIVE_RENAMER_H
+#define _NATIVE_RENAMER_H
+
+#include "NativeCurveScaler.h"
+#include "../JointMap.h"
+
+class FileReport;
+
+struct NativeRenameResult
+{
+    NativeRenameResult() : mRenamed(0), mBytesWritten(0), mInPlace(false) {}
+
+    int mRenamed;
+    long long mBytesWritten;
+    bool mInPlace;
+    NativeScaleResult mScale;
+};
+
+/** Rename skeleton joints of a binary FBX file without an SDK import/export round trip.
+  *
+  * Only the name strings of skeleton Model records change. Connections, bind pose
+  * nodes and cluster links refer to models by object id in FBX 7.x, so they stay
+  * valid. Record end offsets and the footer alignment are fixed up in one forward
+  * pass while the file is copied with large sequential writes, see NativePatchPlan.
+  * If pOutput names the input file and nothing changes length, the file is patched
+  * in place through a writable mapping instead.
+  *
+  * With a scale other than 1, translations are scaled in the same pass, see
+  * PlanNativeTranslations. All changes are planned before anything is written,
+  * so a file that cannot be scaled is rejected without a renamed, unscaled output.
+  *
+  * Unlike the SDK pipeline this does not resolve duplicate names, strip the root
+  * scale or convert units.
+  *
+  * /param pInput The binary FBX file to read.
+  * /param pOutput The file to write; may be the same as pInput.
+  * /param pJointMap Old to new joint name table.
+  * /param pScale Factor applied to all translations; 1 leaves them unchanged.
+  * /param pResult Optional statistics.
+  * /param pReport If not NULL, receives the old and new name and type of every skeleton joint.
+  * /return false on read, parse, scale or write errors.
+  */
+bool RenameNative(const char* pInput, const char* pOutput, const JointMap& pJointMap, double pScale = 1.0,
+                  NativeRenameResult* pResult = NULL, FileReport* pReport = NULL);
+
+#endif // #ifndef _NATIVE_RENAMER_H
@@ -0,0 +1,550 @@
+#include "Pipeline.h"
+#include "AnimationBaker.h"
+#include "Common/Common.h"
+#include "Common/FileUtility.h"
+#include "Common/Log.h"
+#include "Common/ParallelFor.h"
+#include "DisplayCommon.h"
+#include "DisplaySkeleton.h"
+#include "KeyReducer.h"
+#include "Native/NativeRenamer.h"
+#include "RenameReport.h"
+#include "ResultCache.h"
+#include "SceneTable.h"
+#include "ScaleCache.h"
+#include "UnitConversion.h"
+
+#include <algorithm>
+
+// Local function prototypes.
+void DisplayContent(const SceneTable& pTable, const JointMap& pJointMap, RenameContext& pContext);
+void DisplayMetaData(FbxScene* pScene);
+
+// A translation curve and the accumulated parent scale to apply to it.
+struct CurveScale
+{
+    FbxAnimCurve* mCurve;
+    double mFactor;
+    // With animated scale, one extra factor per key; empty when the scale is constant.
+    std::vector<float> mKeyFactors;
+
+    bool operator<(const CurveScale& pOther) const { return mCurve < pOther.mCurve; }
+};
+
+void CollectCurveScales(const SceneTable& pTable, const SceneTableLayer& pLayer, double pUnitFactor, std::vector<CurveScale>& pScales);
+void CollectAnimatedCurveScales(const SceneTable& pTable, const SceneTableLayer& pLayer, double pUnitFactor, std::vector<CurveScale>& pScales);
+void ApplyCurveScales(std::vector<CurveScale>& pScales, int pThreads);
+static bool RunPipeline(FbxManager* pManager, FbxScene* pScene, const char* pInput, const char* pOutput,
+                        const PipelineOptions& pOptions, const JointMap& pJointMap, FileProfile* pProfile,
+                        FileReport* pReport);
+
+bool ProcessFile(FbxManager* pManager, FbxScene* pScene, const char* pInput, const char* pOutput,
+                 const PipelineOptions& pOptions, const JointMap& pJointMap, FileProfile* pProfile)
+{
+    LOG_INFO("\n\nFile: %s\n\n", pInput);
+
+    // The file's records are built locally and added to the shared report in one piece.
+    FileReport lReport(pOptions.mReport ? pOptions.mReport->GetFormat() : eReportJson);
+    FileReport* lReportPointer = pOptions.mReport ? &lReport : NULL;
+    if (lReportPointer)
+        lReport.Begin(pInput, pOutput);
+
+    // Hashing the input is far cheaper than loading it, so check the cache first.
+    // With a report, a hit also needs the joint records kept with the entry.
+    PhaseTimer lTimer(pProfile);
+    std::string lCacheKey;
+    std::string lCachedReport;
+    if (pOptions.mCache)
+        lCacheKey = pOptions.mCache->MakeKey(pInput, GetOptionsKey(pOptions), pJointMap.GetContentHash());
+    const bool lCacheHit = !lCacheKey.empty() && pOptions.mCache->Fetch(lCacheKey, pOutput, lReportPointer ? &lCachedReport : NULL);
+    lTimer.Stop(ePhaseCache);
+
+    bool lResult = true;
+    if (lCacheHit)
+    {
+        LOG_INFO("Result cache hit, copied to %s\n", pOutput);
+        if (lReportPointer)
+            lReport.Replay(lCachedReport);
+    }
+    else
+    {
+        if (!lCacheKey.empty())
+            pOptions.mCache->DetachOutput(pInput, pOutput);
+        lResult = RunPipeline(pManager, pScene, pInput, pOutput, pOptions, pJointMap, pProfile, lReportPointer);
+        lTimer.Skip();
+        if (lResult && !lCacheKey.empty())
+        {
+            if (lReportPointer)
+                lCachedReport = lReport.GetFragment();
+            pOptions.mCache->Store(lCacheKey, pOutput, lReportPointer ? &lCachedReport : NULL);
+        }
+        lTimer.Stop(ePhaseCache);
+    }
+
+    if (lReportPointer)
+    {
+        lReport.End(lResult, lCacheHit);
+        pOptions.mReport->Add(lReport);
+    }
+
+    if (pProfile)
+    {
+        pProfile->mInput = pInput;
+        pProfile->mContent = pOptions.mNativeRename ? "native" : GetContentProfileName(pOptions.mContent);
+        pProfile->mOutput = pOutput;
+        pProfile->mResult = lResult;
+        pProfile->mCacheHit = lCacheHit;
+        pProfile->mFileSize = GetFileSize(pInput);
+        pProfile->mPeakMemory = GetPeakMemoryUsage();
+    }
+    return lResult;
+}
+
+static void AppendPatterns(std::string& pKey, const char* pName, const std::vector<std::string>& pPatterns)
+{
+    pKey += pName;
+    for (size_t i = 0; i < pPatterns.size(); ++i)
+    {
+        // Patterns cannot contain commas, so the list stays unambiguous.
+        pKey += i == 0 ? "=" : ",";
+        pKey += pPatterns[i];
+    }
+    pKey += "\n";
+}
+
+std::string GetOptionsKey(const PipelineOptions& pOptions)
+{
+    // Only numbers and fixed names go through the buffer; the version string comes
+    // from the command line or a daemon request and is appended as is.
+    char lBuffer[512];
+    sprintf(lBuffer, "removeanim=%d\nnativerename=%d\nnativescale=%.17g\nanimscale=%d\ncontent=%s\nreducekeys=%.17g\nbake=%.17g\nfuseunits=%d\n"
+                     "format=%d\nfbxversion=",
+            (int)pOptions.mRemoveAnim, (int)pOptions.mNativeRename, pOptions.mNativeScale, (int)pOptions.mAnimatedScale,
+            GetContentProfileName(pOptions.mContent), pOptions.mKeyTolerance, pOptions.mBakeRate, (int)pOptions.mFuseUnits, (int)pOptions.mExport.mFormat);
+
+    std::string lKey = lBuffer;
+    lKey += pOptions.mExport.mVersion.Buffer();
+    sprintf(lBuffer, "\ncompress=%d\nembed=%d\n", pOptions.mExport.mCompressionLevel, (int)pOptions.mExport.mEmbedMedia);
+    lKey += lBuffer;
+    // Part of the key only with key reduction, so other entries stay valid.
+    if (pOptions.mKeyTolerance > 0.0)
+    {
+        sprintf(lBuffer, "reducekeysscaling=%.17g\n", pOptions.mKeyTolerance * SCALE_TOLERANCE_PER_CM);
+        lKey += lBuffer;
+    }
+    AppendPatterns(lKey, "takes", pOptions.mIncludeTakes);
+    AppendPatterns(lKey, "excludetakes", pOptions.mExcludeTakes);
+    return lKey;
+}
+
+static bool RunPipeline(FbxManager* pManager, FbxScene* pScene, const char* pInput, const char* pOutput,
+                        const PipelineOptions& pOptions, const JointMap& pJointMap, FileProfile* pProfile,
+                        FileReport* pReport)
+{
+    PhaseTimer lTimer(pProfile);
+
+    if (pOptions.mNativeRename)
+    {
+        // Renaming and scaling patch the file in one pass, so the time is charged to renaming.
+        bool lResult = RenameNative(pInput, pOutput, pJointMap, pOptions.mNativeScale, NULL, pReport);
+        LogFlush();
+        lTimer.Stop(ePhaseRename);
+        return lResult;
+    }
+
+    ImportOptions importOptions;
+    importOptions.mContent = pOptions.mContent;
+    importOptions.mSkipAnimation = pOptions.mRemoveAnim;
+    importOptions.mIncludeTakes = pOptions.mIncludeTakes;
+    importOptions.mExcludeTakes = pOptions.mExcludeTakes;
+    importOptions.mPromptPassword = pOptions.mPromptPassword;
+    if (!LoadScene(pManager, pScene, pInput, importOptions))
+    {
+        LOG_ERROR("\n\nAn error occurred while loading %s\n", pInput);
+        lTimer.Stop(ePhaseLoad);
+        return false;
+    }
+    LogFlush();
+    lTimer.Stop(ePhaseLoad);
+
+    // Counting walks every curve, so only do it when profiling, and keep it out of the timings.
+    if (pProfile)
+    {
+        CountSceneContent(pScene, *pProfile);
+        lTimer.Skip();
+    }
+
+    // Flatten the hierarchy and look up the curves once for all passes below.
+    SceneTable lTable;
+    lTable.Build(pScene);
+
+    if (pOptions.mBakeRate > 0.0 && !pOptions.mRemoveAnim)
+    {
+        BakeResult lBake;
+        BakeSceneAnimation(pScene, lTable, pOptions.mBakeRate, pOptions.mScaleThreads, lBake);
+        // Baking removes curve nodes from all but the first layer of each stack.
+        lTable.Build(pScene);
+        LogFlush();
+        lTimer.Stop(ePhaseBake);
+    }
+
+    // With -fuseunits the unit conversion is folded into the limb size and
+    // curve scale passes below instead of running as a separate scene walk.
+    const double unitFactor = GetUnitFactor(pScene, FbxSystemUnit::cm);
+    const bool fuseUnits = pOptions.mFuseUnits && unitFactor != 1.0;
+
+    // Display the scene.
+    RenameContext lContext;
+    lContext.mUnitFactor = fuseUnits ? unitFactor : 1.0;
+    lContext.mReport = pReport;
+    FbxDocumentInfo* lInfo = pScene->GetSceneInfo();
+    if (pReport && lInfo)
+    {
+        pReport->Metadata(lInfo->mTitle.Buffer(), lInfo->mSubject.Buffer(), lInfo->mAuthor.Buffer(),
+                          lInfo->mKeywords.Buffer(), lInfo->mRevision.Buffer(), lInfo->mComment.Buffer());
+    }
+    DisplayMetaData(pScene);
+    DisplayContent(lTable, pJointMap, lContext);
+    LOG_INFO("Renamed %d of %d joints\n", lContext.mRenamed, lContext.mJoints);
+    // One line per scene; -verbose lists every duplicate.
+    if (lContext.mDuplicates > 0)
+        LOG_WARNING("Warning: %s: %d duplicate joint names were made unique\n", pInput, lContext.mDuplicates);
+    LogFlush();
+    lTimer.Stop(ePhaseRename);
+
+    // Parse all the nodes to convert the translations and meshes vertices.
+    // Scale factors of every stack and layer are collected first, then the keys
+    // of all translation curves are scaled in one pass that can run in parallel.
+    // With -removeanim no takes were imported, so there is nothing to scale.
+    if (!pOptions.mRemoveAnim)
+    {
+        const std::vector<SceneTableLayer>& layers = lTable.GetLayers();
+        std::vector<CurveScale> curveScales;
+        for (size_t i = 0; i < layers.size(); ++i)
+        {
+            if (i == 0 || layers[i].mStack != layers[i - 1].mStack)
+                LOG_INFO("Scaling Stack %s\n", layers[i].mStack->GetName());
+
+            LOG_INFO("  Scaling Layer %s\n", layers[i].mLayer->GetName());
+            if (pOptions.mAnimatedScale)
+                CollectAnimatedCurveScales(lTable, layers[i], lContext.mUnitFactor, curveScales);
+            else
+                CollectCurveScales(lTable, layers[i], lContext.mUnitFactor, curveScales);
+        }
+        ApplyCurveScales(curveScales, pOptions.mScaleThreads);
+    }
+
+    LogFlush();
+    lTimer.Stop(ePhaseScaleCurves);
+
+    // Takes are deselected before import; this only catches stacks from readers
+    // that do not honor the selection.
+    int numAnimStacks = pScene->GetSrcObjectCount(FbxCriteria::ObjectType(FbxAnimStack::ClassId));
+    if (pOptions.mRemoveAnim)
+    {
+        for (int i = numAnimStacks - 1; i >= 0; --i)
+        {
+            FbxAnimStack* stack = FbxCast<FbxAnimStack>(pScene->GetSrcObject(FbxCriteria::ObjectType(FbxAnimStack::ClassId), i));
+            LOG_INFO("Removing Anim Stack %s\n", stack->GetName());
+            pScene->RemoveAnimStack(stack->GetName());
+        }
+    }
+
+    lTimer.Stop(ePhaseRemoveAnim);
+
+    // Files already in centimeters need no conversion walk at all.
+    FbxGlobalSettings& settings = pScene->GetGlobalSettings();
+    if (fuseUnits)
+    {
+        UnitConversionResult conversion;
+        ApplyUnitFactor(pScene, lTable, unitFactor, conversion);
+    }
+    else if (unitFactor != 1.0)
+    {
+        FbxSystemUnit::cm.ConvertScene(pScene);
+    }
+    settings.SetSystemUnit(FbxSystemUnit::cm);
+    pScene->GetAnimationEvaluator()->Reset();
+    LogFlush();
+    lTimer.Stop(ePhaseConvertUnits);
+
+    // Reduce after every pass that changes key values, so the tolerance applies
+    // to the values that are written, in centimeters.
+    if (pOptions.mKeyTolerance > 0.0 && !pOptions.mRemoveAnim)
+    {
+        KeyReductionResult lReduction;
+        ReduceSceneKeys(pScene, pOptions.mKeyTolerance, lReduction);
+        if (pProfile)
+        {
+            pProfile->mReducedKeys = lReduction.mKeysAfter;
+            pProfile->mRemovedCurves = lReduction.mConstantCurves;
+        }
+        LogFlush();
+    }
+    lTimer.Stop(ePhaseReduceKeys);
+
+    ExportOptions exportOptions = pOptions.mExport;
+    exportOptions.mContent = pOptions.mContent;
+    if (!SaveScene(pManager, pScene, pOutput, exportOptions))
+    {
+        LOG_ERROR("\n\nAn error occurred while saving %s\n", pOutput);
+        lTimer.Stop(ePhaseSave);
+        return false;
+    }
+    LogFlush();
+    lTimer.Stop(ePhaseSave);
+
+    return true;
+}
+
+void ApplyComponentScale(FbxNode* pNode, const SceneTableCurves& pCurves, FbxVectorTemplate3<double>& scale, int component,
+                         std::vector<CurveScale>& pScales)
+{
+    static const char* const componentNames[3] = { "X", "Y", "Z" };
+
+    // Apply parent scale first. A factor of one leaves the keys as they are.
+    FbxAnimCurve* translation = pCurves.mTranslation[component];
+    if (translation && scale[component] != 1.0)
+    {
+        LOG_TRACE("      Trans %s %s\n", componentNames[component], pNode->GetName());
+        pScales.push_back(CurveScale());
+        pScales.back().mCurve = translation;
+        pScales.back().mFactor = scale[component];
+    }
+
+    // Add local scale for child scaling
+    FbxAnimCurve* lclScale = pCurves.mScaling[component];
+    if (lclScale)
+    {
+        LOG_TRACE("      Scale %s %s\n", componentNames[component], pNode->GetName());
+        scale[component] *= lclScale->GetValue();
+        lclScale->KeyClear();
+    }
+}
+
+void CollectCurveScales(const SceneTable& pTable, const SceneTableLayer& pLayer, double pUnitFactor, std::vector<CurveScale>& pScales)
+{
+    if (pLayer.mAnimatedNodes == 0)
+        return;
+
+    // Parents come before children, so each node starts from its parent's accumulated
+    // scale. The root starts from the unit factor, so it reaches every translation.
+    const std::vector<SceneTableNode>& nodes = pTable.GetNodes();
+    std::vector<FbxVectorTemplate3<double> > scales(nodes.size());
+    for (size_t i = 0; i < nodes.size(); ++i)
+    {
+        FbxVectorTemplate3<double> scale = nodes[i].mParent >= 0 ? scales[nodes[i].mParent]
+                                                                 : FbxVectorTemplate3<double>(pUnitFactor, pUnitFactor, pUnitFactor);
+
+        LOG_TRACE("    Scaling %s\n", nodes[i].mNode->GetName());
+        for (int component = 0; component < 3; ++component)
+        {
+            ApplyComponentScale(nodes[i].mNode, pLayer.mCurves[i], scale, component, pScales);
+        }
+        LOG_TRACE("      New scale %f, %f, %f\n", scale[0], scale[1], scale[2]);
+
+        scales[i] = scale;
+    }
+}
+
+void CollectAnimatedCurveScales(const SceneTable& pTable, const SceneTableLayer& pLayer, double pUnitFactor, std::vector<CurveScale>& pScales)
+{
+    if (pLayer.mAnimatedNodes == 0)
+        return;
+
+    // Sample every scale curve before any of them is cleared.
+    ScaleCache cache;
+    cache.Build(pTable, pLayer);
+    LOG_TRACE("    %d scale samples\n", (int)cache.GetSampleCount());
+
+    const std::vector<SceneTableNode>& nodes = pTable.GetNodes();
+    for (size_t i = 0; i < nodes.size(); ++i)
+    {
+        const SceneTableCurves& curves = pLayer.mCurves[i];
+        for (int component = 0; component < 3; ++component)
+        {
+            FbxAnimCurve* translation = curves.mTranslation[component];
+            if (!translation)
+                continue;
+            if (cache.HasParentScale((int)i))
+            {
+                pScales.push_back(CurveScale());
+                pScales.back().mCurve = translation;
+                pScales.back().mFactor = pUnitFactor;
+                cache.GetParentFactors((int)i, component, translation, pScales.back().mKeyFactors);
+            }
+            else if (pUnitFactor != 1.0)
+            {
+                pScales.push_back(CurveScale());
+                pScales.back().mCurve = translation;
+                pScales.back().mFactor = pUnitFactor;
+            }
+        }
+    }
+
+    // The scale is now baked into the translations below it.
+    for (size_t i = 0; i < nodes.size(); ++i)
+    {
+        for (int component = 0; component < 3; ++component)
+        {
+            if (pLayer.mCurves[i].mScaling[component])
+                pLayer.mCurves[i].mScaling[component]->KeyClear();
+        }
+    }
+}
+
+static void MergeCurveScale(CurveScale& pInto, const CurveScale& pFrom)
+{
+    pInto.mFactor *= pFrom.mFactor;
+    if (pFrom.mKeyFactors.empty())
+        return;
+    if (pInto.mKeyFactors.empty())
+    {
+        pInto.mKeyFactors = pFrom.mKeyFactors;
+        return;
+    }
+    for (size_t k = 0; k < pInto.mKeyFactors.size() && k < pFrom.mKeyFactors.size(); ++k)
+        pInto.mKeyFactors[k] *= pFrom.mKeyFactors[k];
+}
+
+static void ScaleCurve(CurveScale& pScale)
+{
+    FbxAnimCurve* curve = pScale.mCurve;
+    if (pScale.mKeyFactors.empty())
+    {
+        curve->KeyScaleValueAndTangent((float)pScale.mFactor);
+        return;
+    }
+
+    // Automatic tangents follow the new values; only user set tangents are stored
+    // and need scaling with their key.
+    for (int k = 0, count = curve->KeyGetCount(); k < count; ++k)
+    {
+        const float factor = (float)(pScale.mKeyFactors[k] * pScale.mFactor);
+        curve->KeySetValue(k, curve->KeyGetValue(k) * factor);
+        if (curve->KeyGetTangentMode(k) & FbxAnimCurveDef::eTangentUser)
+        {
+            curve->KeySetLeftDerivative(k, curve->KeyGetLeftDerivative(k) * factor);
+            curve->KeySetRightDerivative(k, curve->KeyGetRightDerivative(k) * factor);
+        }
+    }
+}
+
+void ApplyCurveScales(std::vector<CurveScale>& pScales, int pThreads)
+{
+    // A curve may be connected to several properties; merge its factors so no
+    // curve is scaled by two threads at once.
+    std::sort(pScales.begin(), pScales.end());
+    size_t count = 0;
+    for (size_t i = 0; i < pScales.size(); ++i)
+    {
+        if (count > 0 && pScales[count - 1].mCurve == pScales[i].mCurve)
+            MergeCurveScale(pScales[count - 1], pScales[i]);
+        else if (count != i)
+            std::swap(pScales[count++], pScales[i]);
+        else
+            ++count;
+    }
+    pScales.resize(count);
+
+    if (pThreads == 1)
+    {
+        for (size_t i = 0; i < pScales.size(); ++i)
+        {
+            pScales[i].mCurve->KeyModifyBegin();
+            ScaleCurve(pScales[i]);
+            pScales[i].mCurve->KeyModifyEnd();
+        }
+        return;
+    }
+
+    // SDK boundary: KeyModifyBegin/End raise change notifications through the
+    // curve nodes and the scene, so they stay on this thread. In between, each
+    // worker only rewrites the key buffers of the curves it was handed.
+    for (size_t i = 0; i < pScales.size(); ++i)
+        pScales[i].mCurve->KeyModifyBegin();
+
+    ParallelFor(pScales.size(), 64, pThreads, [&pScales](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+            ScaleCurve(pScales[i]);
+    });
+
+    for (size_t i = 0; i < pScales.size(); ++i)
+        pScales[i].mCurve->KeyModifyEnd();
+}
+
+void DisplayContent(const SceneTable& pTable, const JointMap& pJointMap, RenameContext& pContext)
+{
+	const std::vector<SceneTableNode>& lNodes = pTable.GetNodes();
+
+	// Entry 0 is the scene root itself, which the rename pass never touches.
+	for (size_t i = 1; i < lNodes.size(); ++i)
+	{
+		if (lNodes[i].mAttributeType == FbxNodeAttribute::eUnknown)
+		{
+			LOG_TRACE("NULL Node Attribute\n\n");
+			continue;
+		}
+
+		switch (lNodes[i].mAttributeType)
+		{
+		default:
+			break;
+
+		case FbxNodeAttribute::eSkeleton:
+			DisplaySkeleton(lNodes[i].mNode, pJointMap, pContext);
+			break;
+
+		}
+	}
+}
+
+
+
+
+
+void DisplayMetaData(FbxScene* pScene)
+{
+	FbxDocumentInfo* sceneInfo = pScene->GetSceneInfo();
+	if (sceneInfo && LogEnabled(eLogTrace))
+	{
+		LogWrite(eLogTrace, "\n\n--------------------\nMeta-Data\n--------------------\n\n");
+		LogWrite(eLogTrace, "    Title: %s\n", sceneInfo->mTitle.Buffer());
+		LogWrite(eLogTrace, "    Subject: %s\n", sceneInfo->mSubject.Buffer());
+		LogWrite(eLogTrace, "    Author: %s\n", sceneInfo->mAuthor.Buffer());
+		LogWrite(eLogTrace, "    Keywords: %s\n", sceneInfo->mKeywords.Buffer());
+		LogWrite(eLogTrace, "    Revision: %s\n", sceneInfo->mRevision.Buffer());
+		LogWrite(eLogTrace, "    Comment: %s\n", sceneInfo->mComment.Buffer());
+
+		FbxThumbnail* thumbnail = sceneInfo->GetSceneThumbnail();
+		if (thumbnail)
+		{
+			LogWrite(eLogTrace, "    Thumbnail:\n");
+
+			switch (thumbnail->GetDataFormat())
+			{
+			case FbxThumbnail::eRGB_24:
+				LogWrite(eLogTrace, "        Format: RGB\n");
+				break;
+			case FbxThumbnail::eRGBA_32:
+				LogWrite(eLogTrace, "        Format: RGBA\n");
+				break;
+			}
+
+			switch (thumbnail->GetSize())
+			{
+			default:
+				break;
+			case FbxThumbnail::eNotSet:
+				LogWrite(eLogTrace, "        Size: no dimensions specified (%ld bytes)\n", thumbnail->GetSizeInBytes());
+				break;
+			case FbxThumbnail::e64x64:
+				LogWrite(eLogTrace, "        Size: 64 x 64 pixels (%ld bytes)\n", thumbnail->GetSizeInBytes());
+				break;
+			case FbxThumbnail::e128x128:
+				LogWrite(eLogTrace, "        Size: 128 x 128 pixels (%ld bytes)\n", thumbnail->GetSizeInBytes());
+			}
+		}
+	}
+}
@@ -0,0 +1,65 @@
+#ifndef _PIPELINE_H
+#define _PIPELINE_H
+
+#include <fbxsdk.h>
+#include "Common/Common.h"
+#include "JointMap.h"
+#include "Profile.h"
+
+class RenameReport;
+class ResultCache;
+
+struct PipelineOptions
+{
+    PipelineOptions() : mRemoveAnim(false), mNativeRename(false), mScaleThreads(1), mNativeScale(1.0), mAnimatedScale(false), mContent(eContentFull), mKeyTolerance(0.0), mBakeRate(0.0), mFuseUnits(false), mPromptPassword(true), mCache(NULL), mReport(NULL) {}
+
+    bool mRemoveAnim;
+    // Rename joints by patching the binary file directly, without the SDK.
+    bool mNativeRename;
+    ExportOptions mExport;
+    // Threads used to bake and scale animation keys; 1 runs serially, 0 uses one per hardware thread.
+    int mScaleThreads;
+    // With mNativeRename, multiply all translations of the written file by this factor.
+    double mNativeScale;
+    // Propagate animated parent scale per key instead of using the scale curve defaults.
+    bool mAnimatedScale;
+    // What is imported and exported; ignored by native renaming, which keeps the whole file.
+    EContentProfile mContent;
+    // Take name patterns, see ImportOptions. Ignored by native renaming.
+    std::vector<std::string> mIncludeTakes;
+    std::vector<std::string> mExcludeTakes;
+    // Remove keys that change curves by at most this much after conversion; 0 keeps all keys.
+    double mKeyTolerance;
+    // Resample the transform animation of every stack at this many frames per second before scaling; 0 keeps the keys.
+    double mBakeRate;
+    // Fold the conversion to centimeters into the scale passes instead of FbxSystemUnit::ConvertScene.
+    bool mFuseUnits;
+    // See ImportOptions; batch workers and the daemon turn this off.
+    bool mPromptPassword;
+    // If set, results are looked up here before running and stored after. Shared by all workers.
+    ResultCache* mCache;
+    // If set, each file adds its metadata and per-joint rename record here. Shared by all workers.
+    RenameReport* mReport;
+};
+
+/** Text describing every option that changes the output, for result cache keys.
+  * Options that only affect speed, such as the thread count, are left out.
+  */
+std::string GetOptionsKey(const PipelineOptions& pOptions);
+
+/** Run the whole per-file pipeline: load, optionally bake, rename joints, scale curves, convert to
+  * centimeters, optionally reduce keys and save. Only touches the given manager and scene, so several
+  * pipelines can run concurrently as long as each has its own manager.
+  * /param pManager The manager owning pScene.
+  * /param pScene An empty scene to import into.
+  * /param pInput The FBX file to read.
+  * /param pOutput The FBX file to write.
+  * /param pOptions Processing flags.
+  * /param pJointMap Old to new joint name table, shared read-only between pipelines.
+  * /param pProfile If not NULL, receives per-phase timings and scene statistics.
+  * /return true if the file was loaded and saved, or copied from the result cache.
+  */
+bool ProcessFile(FbxManager* pManager, FbxScene* pScene, const char* pInput, const char* pOutput,
+                 const PipelineOptions& pOptions, const JointMap& pJointMap, FileProfile* pProfile = NULL);
+
+#endif // #ifndef _PIPELINE_H
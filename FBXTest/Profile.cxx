@@ -0,0 +1,188 @@
+#include "Profile.h"
+#include "Common/JsonWriter.h"
+
+#include <algorithm>
+
+#if defined(_WIN32)
+    #include <windows.h>
+    #include <psapi.h>
+    #pragma comment(lib, "psapi.lib")
+#else
+    #include <sys/resource.h>
+#endif
+
+static const char* const gPhaseNames[ePhaseCount] =
+{
+    "cache", "load", "bake", "rename", "scaleCurves", "removeAnim", "convertUnits", "reduceKeys", "save"
+};
+
+const char* GetPhaseName(EProfilePhase pPhase)
+{
+    return gPhaseNames[pPhase];
+}
+
+FileProfile::FileProfile()
+    : mResult(false)
+    , mCacheHit(false)
+    , mFileSize(0)
+    , mTotalSeconds(0.0)
+    , mPeakMemory(0)
+    , mNodes(0)
+    , mCurves(0)
+    , mKeys(0)
+    , mReducedKeys(-1)
+    , mRemovedCurves(0)
+{
+    for (int i = 0; i < ePhaseCount; ++i)
+    {
+        mPhaseSeconds[i] = 0.0;
+        mAllocations[i] = 0;
+        mAllocatedBytes[i] = 0;
+    }
+}
+
+PhaseTimer::PhaseTimer(FileProfile* pProfile)
+    : mProfile(pProfile)
+    , mLast(std::chrono::steady_clock::now())
+    , mLastAllocations(GetThreadAllocations())
+{
+}
+
+void PhaseTimer::Stop(EProfilePhase pPhase)
+{
+    if (!mProfile)
+        return;
+
+    std::chrono::steady_clock::time_point lNow = std::chrono::steady_clock::now();
+    double lSeconds = std::chrono::duration<double>(lNow - mLast).count();
+    mProfile->mPhaseSeconds[pPhase] += lSeconds;
+    mProfile->mTotalSeconds += lSeconds;
+    mLast = lNow;
+
+    const AllocationCounters lAllocations = GetThreadAllocations();
+    mProfile->mAllocations[pPhase] += lAllocations.mCalls - mLastAllocations.mCalls;
+    mProfile->mAllocatedBytes[pPhase] += lAllocations.mBytes - mLastAllocations.mBytes;
+    mLastAllocations = lAllocations;
+}
+
+void PhaseTimer::Skip()
+{
+    mLast = std::chrono::steady_clock::now();
+    mLastAllocations = GetThreadAllocations();
+}
+
+long long GetPeakMemoryUsage()
+{
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS lCounters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &lCounters, sizeof(lCounters)))
+        return (long long)lCounters.PeakWorkingSetSize;
+    return 0;
+#else
+    struct rusage lUsage;
+    if (getrusage(RUSAGE_SELF, &lUsage) != 0)
+        return 0;
+    #if defined(__APPLE__)
+        return (long long)lUsage.ru_maxrss;             // bytes
+    #else
+        return (long long)lUsage.ru_maxrss * 1024;      // kilobytes
+    #endif
+#endif
+}
+
+void CountSceneContent(FbxScene* pScene, FileProfile& pProfile)
+{
+    pProfile.mNodes = pScene->GetNodeCount();
+    pProfile.mCurves = pScene->GetSrcObjectCount<FbxAnimCurve>();
+    pProfile.mKeys = 0;
+    for (int i = 0; i < pProfile.mCurves; ++i)
+    {
+        pProfile.mKeys += pScene->GetSrcObject<FbxAnimCurve>(i)->KeyGetCount();
+    }
+}
+
+static bool SlowerFirst(const FileProfile* pA, const FileProfile* pB)
+{
+    return pA->mTotalSeconds > pB->mTotalSeconds;
+}
+
+void PrintProfileReport(const std::vector<FileProfile>& pProfiles)
+{
+    std::vector<const FileProfile*> lSorted;
+    for (size_t i = 0; i < pProfiles.size(); ++i)
+        lSorted.push_back(&pProfiles[i]);
+    std::stable_sort(lSorted.begin(), lSorted.end(), SlowerFirst);
+
+    FBXSDK_printf("\nProfile (seconds)\n");
+    FBXSDK_printf("%10s", "total");
+    for (int p = 0; p < ePhaseCount; ++p)
+        FBXSDK_printf(" %12s", gPhaseNames[p]);
+    FBXSDK_printf(" %8s %8s %8s %10s %10s  %s\n", "profile", "nodes", "curves", "keys", "peak MB", "file");
+
+    for (size_t i = 0; i < lSorted.size(); ++i)
+    {
+        const FileProfile& lProfile = *lSorted[i];
+        FBXSDK_printf("%10.4f", lProfile.mTotalSeconds);
+        for (int p = 0; p < ePhaseCount; ++p)
+            FBXSDK_printf(" %12.4f", lProfile.mPhaseSeconds[p]);
+        FBXSDK_printf(" %8s %8d %8d %10lld %10.1f  %s%s\n", lProfile.mContent.c_str(), lProfile.mNodes, lProfile.mCurves, lProfile.mKeys,
+                      lProfile.mPeakMemory / (1024.0 * 1024.0), lProfile.mInput.c_str(),
+                      lProfile.mResult ? (lProfile.mCacheHit ? " (cached)" : "") : " (failed)");
+    }
+}
+
+bool SaveProfileReport(const std::vector<FileProfile>& pProfiles, const char* pFileName)
+{
+    JsonWriter lJson;
+    lJson.BeginObject();
+    lJson.Key("files");
+    lJson.BeginArray();
+    for (size_t i = 0; i < pProfiles.size(); ++i)
+    {
+        const FileProfile& lProfile = pProfiles[i];
+        lJson.BeginObject();
+        lJson.Key("input");         lJson.String(lProfile.mInput.c_str());
+        lJson.Key("output");        lJson.String(lProfile.mOutput.c_str());
+        lJson.Key("success");       lJson.Bool(lProfile.mResult);
+        lJson.Key("content");       lJson.String(lProfile.mContent.c_str());
+        lJson.Key("cacheHit");      lJson.Bool(lProfile.mCacheHit);
+        lJson.Key("bytes");         lJson.Int(lProfile.mFileSize);
+        lJson.Key("nodes");         lJson.Int(lProfile.mNodes);
+        lJson.Key("curves");        lJson.Int(lProfile.mCurves);
+        lJson.Key("keys");          lJson.Int(lProfile.mKeys);
+        if (lProfile.mReducedKeys >= 0)
+        {
+            lJson.Key("reducedKeys");   lJson.Int(lProfile.mReducedKeys);
+            lJson.Key("removedCurves"); lJson.Int(lProfile.mRemovedCurves);
+        }
+        lJson.Key("peakMemory");    lJson.Int(lProfile.mPeakMemory);
+        lJson.Key("seconds");       lJson.Double(lProfile.mTotalSeconds);
+        lJson.Key("phases");
+        lJson.BeginObject();
+        for (int p = 0; p < ePhaseCount; ++p)
+        {
+            lJson.Key(gPhaseNames[p]);
+            lJson.Double(lProfile.mPhaseSeconds[p]);
+        }
+        lJson.EndObject();
+        if (IsAllocationTrackerInstalled())
+        {
+            lJson.Key("allocations");
+            lJson.BeginObject();
+            for (int p = 0; p < ePhaseCount; ++p)
+            {
+                lJson.Key(gPhaseNames[p]);
+                lJson.BeginObject();
+                lJson.Key("calls"); lJson.Int(lProfile.mAllocations[p]);
+                lJson.Key("bytes"); lJson.Int(lProfile.mAllocatedBytes[p]);
+                lJson.EndObject();
+            }
+            lJson.EndObject();
+        }
+        lJson.EndObject();
+    }
+    lJson.EndArray();
+    lJson.EndObject();
+
+    return lJson.Save(pFileName);
+}
@@ -0,0 +1,87 @@
+#ifndef _PROFILE_H
+#define _PROFILE_H
+
+#include <fbxsdk.h>
+#include "MemoryTracker.h"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+enum EProfilePhase
+{
+    ePhaseCache,
+    ePhaseLoad,
+    ePhaseBake,
+    ePhaseRename,
+    ePhaseScaleCurves,
+    ePhaseRemoveAnim,
+    ePhaseConvertUnits,
+    ePhaseReduceKeys,
+    ePhaseSave,
+    ePhaseCount
+};
+
+const char* GetPhaseName(EProfilePhase pPhase);
+
+/** Timings and content statistics for one processed file. */
+struct FileProfile
+{
+    FileProfile();
+
+    std::string mInput;
+    std::string mOutput;
+    // Content profile the file was processed with, "native" for native renaming.
+    std::string mContent;
+    bool mResult;
+    // The output was copied from the result cache; the other phases did not run.
+    bool mCacheHit;
+    long long mFileSize;
+    double mPhaseSeconds[ePhaseCount];
+    // SDK allocations made by the pipeline thread, with -memstats or -arena.
+    long long mAllocations[ePhaseCount];
+    long long mAllocatedBytes[ePhaseCount];
+    double mTotalSeconds;
+    // Process wide peak resident memory when the file finished. In batch mode
+    // this covers every file processed so far on all workers.
+    long long mPeakMemory;
+    int mNodes;
+    int mCurves;
+    long long mKeys;
+    // Keys left and constant curves removed by key reduction; -1 when it did not run.
+    long long mReducedKeys;
+    int mRemovedCurves;
+};
+
+/** Charges the time between successive Stop() calls to pipeline phases.
+  * Does nothing when constructed with a NULL profile.
+  */
+class PhaseTimer
+{
+public:
+    explicit PhaseTimer(FileProfile* pProfile);
+
+    void Stop(EProfilePhase pPhase);
+
+    /** Restart the clock without charging the elapsed time to any phase. */
+    void Skip();
+
+private:
+    FileProfile* mProfile;
+    std::chrono::steady_clock::time_point mLast;
+    AllocationCounters mLastAllocations;
+};
+
+/** Peak resident set size of this process in bytes, 0 if unknown. */
+long long GetPeakMemoryUsage();
+
+/** Fill node, curve and key counts from a loaded scene. */
+void CountSceneContent(FbxScene* pScene, FileProfile& pProfile);
+
+/** Print a table of all profiles through FBXSDK_printf, slowest files first. */
+void PrintProfileReport(const std::vector<FileProfile>& pProfiles);
+
+/** Write all profiles as one JSON document. */
+bool SaveProfileReport(const std::vector<FileProfile>& pProfiles, const char* pFileName);
+
+#endif // #ifndef _PROFILE_H
@@ -0,0 +1,239 @@
+#include "RenameReport.h"
+#include "Common/FileUtility.h"
+
+#include <stdio.h>
+#include <string.h>
+
+enum EJointAction
+{
+    eActionUnique = 1,
+    eActionRenamed = 2,
+    eActionRootScale = 4,
+    eActionResized = 8
+};
+
+static const char* const gActionNames[] = { "unique", "renamed", "rootScale", "resized" };
+
+EReportFormat GetReportFormat(const char* pFileName)
+{
+    return WildcardMatch("*.ndjson", pFileName) || WildcardMatch("*.jsonl", pFileName) ? eReportNdjson : eReportJson;
+}
+
+FileReport::FileReport(EReportFormat pFormat)
+    : mFormat(pFormat)
+    , mInput("")
+    , mOutput("")
+    , mJointCount(0)
+    , mActions(0)
+{
+}
+
+void FileReport::Begin(const char* pInput, const char* pOutput)
+{
+    mInput = pInput;
+    mOutput = pOutput;
+    mJoints.Reserve(4096);
+}
+
+void FileReport::Metadata(const char* pTitle, const char* pSubject, const char* pAuthor,
+                          const char* pKeywords, const char* pRevision, const char* pComment)
+{
+    mMetadata.Clear();
+    mMetadata.BeginObject();
+    mMetadata.Key("title");    mMetadata.String(pTitle);
+    mMetadata.Key("subject");  mMetadata.String(pSubject);
+    mMetadata.Key("author");   mMetadata.String(pAuthor);
+    mMetadata.Key("keywords"); mMetadata.String(pKeywords);
+    mMetadata.Key("revision"); mMetadata.String(pRevision);
+    mMetadata.Key("comment");  mMetadata.String(pComment);
+    mMetadata.EndObject();
+}
+
+void FileReport::BeginJoint(const char* pName)
+{
+    mJoints.BeginObject();
+    mJoints.Key("old"); mJoints.String(pName);
+    mActions = 0;
+    ++mJointCount;
+}
+
+void FileReport::JointUnique(const char* pName)
+{
+    mJoints.Key("unique"); mJoints.String(pName);
+    mActions |= eActionUnique;
+}
+
+void FileReport::JointRenamed(const char* pName)
+{
+    mJoints.Key("new");
+    if (pName)
+    {
+        mJoints.String(pName);
+        mActions |= eActionRenamed;
+    }
+    else
+    {
+        mJoints.Null();
+    }
+}
+
+void FileReport::JointRootScale(double pScale)
+{
+    mJoints.Key("rootScale"); mJoints.Double(pScale);
+    mActions |= eActionRootScale;
+}
+
+void FileReport::JointType(const char* pType)
+{
+    mJoints.Key("type"); mJoints.String(pType);
+}
+
+void FileReport::JointSize(double pBefore, double pAfter)
+{
+    mJoints.Key("sizeBefore"); mJoints.Double(pBefore);
+    mJoints.Key("sizeAfter");  mJoints.Double(pAfter);
+    if (pBefore != pAfter)
+        mActions |= eActionResized;
+}
+
+void FileReport::EndJoint()
+{
+    mJoints.Key("actions");
+    mJoints.BeginArray();
+    for (int i = 0; i < 4; ++i)
+    {
+        if (mActions & (1 << i))
+            mJoints.String(gActionNames[i]);
+    }
+    mJoints.EndArray();
+    mJoints.EndObject();
+    mJoints.NewLine();
+}
+
+std::string FileReport::GetFragment() const
+{
+    // The first line is the metadata object, or null; every following line is a joint.
+    const std::string& lMetadata = mMetadata.GetText();
+    std::string lFragment = lMetadata.empty() ? std::string("null") : lMetadata;
+    lFragment += '\n';
+    lFragment += mJoints.GetText();
+    return lFragment;
+}
+
+void FileReport::Replay(const std::string& pFragment)
+{
+    mMetadata.Clear();
+    mJoints.Clear();
+    mJointCount = 0;
+
+    size_t lLineEnd = pFragment.find('\n');
+    if (lLineEnd == std::string::npos)
+        return;
+    if (pFragment.compare(0, lLineEnd, "null") != 0)
+        mMetadata.Raw(pFragment.data(), lLineEnd);
+
+    for (size_t lLine = lLineEnd + 1; lLine < pFragment.size(); lLine = lLineEnd + 1)
+    {
+        lLineEnd = pFragment.find('\n', lLine);
+        if (lLineEnd == std::string::npos)
+            lLineEnd = pFragment.size();
+        if (lLineEnd == lLine)
+            continue;
+        mJoints.Raw(pFragment.data() + lLine, lLineEnd - lLine);
+        mJoints.NewLine();
+        ++mJointCount;
+    }
+}
+
+void FileReport::End(bool pResult, bool pCached)
+{
+    const std::string& lMetadata = mMetadata.GetText();
+    const std::string& lJoints = mJoints.GetText();
+    mJson.Reserve(lMetadata.size() + lJoints.size() + (mFormat == eReportNdjson ? mJointCount : 1) * (strlen(mInput) + 64));
+
+    if (mFormat == eReportNdjson)
+    {
+        if (!lMetadata.empty())
+        {
+            mJson.BeginObject();
+            mJson.Key("record"); mJson.String("metadata");
+            mJson.Key("file");   mJson.String(mInput);
+            mJson.Members(lMetadata.data(), lMetadata.size());
+            mJson.EndObject();
+            mJson.NewLine();
+        }
+        for (size_t lLine = 0, lLineEnd; lLine < lJoints.size(); lLine = lLineEnd + 1)
+        {
+            lLineEnd = lJoints.find('\n', lLine);
+            mJson.BeginObject();
+            mJson.Key("record"); mJson.String("joint");
+            mJson.Key("file");   mJson.String(mInput);
+            mJson.Members(lJoints.data() + lLine, lLineEnd - lLine);
+            mJson.EndObject();
+            mJson.NewLine();
+        }
+
+        mJson.BeginObject();
+        mJson.Key("record"); mJson.String("file");
+        mJson.Key("input");  mJson.String(mInput);
+        mJson.Key("output"); mJson.String(mOutput);
+    }
+    else
+    {
+        mJson.BeginObject();
+        mJson.Key("input");  mJson.String(mInput);
+        mJson.Key("output"); mJson.String(mOutput);
+        if (!lMetadata.empty())
+        {
+            mJson.Key("metadata"); mJson.Raw(lMetadata.data(), lMetadata.size());
+        }
+        if (mJointCount > 0)
+        {
+            mJson.Key("joints");
+            mJson.BeginArray();
+            for (size_t lLine = 0, lLineEnd; lLine < lJoints.size(); lLine = lLineEnd + 1)
+            {
+                lLineEnd = lJoints.find('\n', lLine);
+                mJson.Raw(lJoints.data() + lLine, lLineEnd - lLine);
+            }
+            mJson.EndArray();
+        }
+    }
+    mJson.Key("jointCount"); mJson.Int(mJointCount);
+    mJson.Key("success");    mJson.Bool(pResult);
+    mJson.Key("cached");     mJson.Bool(pCached);
+    mJson.EndObject();
+    if (mFormat == eReportNdjson)
+        mJson.NewLine();
+}
+
+RenameReport::RenameReport(EReportFormat pFormat)
+    : mFormat(pFormat)
+    , mFiles(0)
+{
+}
+
+void RenameReport::Add(const FileReport& pFile)
+{
+    std::lock_guard<std::mutex> lLock(mMutex);
+    if (mFormat == eReportJson && mFiles > 0)
+        mText += ',';
+    mText += pFile.GetText();
+    ++mFiles;
+}
+
+bool RenameReport::Save(const char* pFileName)
+{
+    std::lock_guard<std::mutex> lLock(mMutex);
+    FILE* lFile = fopen(pFileName, "wb");
+    if (!lFile)
+        return false;
+
+    bool lResult = true;
+    if (mFormat == eReportJson)
+        lResult = fputs("{\"files\":[", lFile) != EOF;
+    lResult = fwrite(mText.data(), 1, mText.size(), lFile) == mText.size() && lResult;
+    if (mFormat == eReportJson)
+        lResult = fputs("]}\n", lFile) != EOF && lResult;
+    return fclose(lFile) == 0 && lResult;
+}
@@ -0,0 +1,97 @@
+#ifndef _RENAME_REPORT_H
+#define _RENAME_REPORT_H
+
+#include "Common/JsonWriter.h"
+
+#include <mutex>
+#include <string>
+
+enum EReportFormat
+{
+    eReportJson,        // One document: {"files": [...]}.
+    eReportNdjson       // One record per line.
+};
+
+/** NDJSON for ".ndjson" and ".jsonl" file names, JSON otherwise. */
+EReportFormat GetReportFormat(const char* pFileName);
+
+/** What the pipeline did to one file, recorded as it happens.
+  *
+  * Events are written straight into one JsonWriter buffer, one joint object per
+  * line, so a joint costs no allocation beyond the buffer's growth. End wraps them
+  * in the requested format: in JSON format the file is one object with "metadata"
+  * and a "joints" array, in NDJSON format every joint is its own line with
+  * "record": "joint", followed by a "file" record with the result.
+  *
+  * The joint lines do not name the file, so the result cache can keep them with
+  * an entry (GetFragment) and a hit can report them again (Replay).
+  *
+  * Joint events must come between BeginJoint and EndJoint, in any order.
+  */
+class FileReport
+{
+public:
+    explicit FileReport(EReportFormat pFormat);
+
+    /** Start the record. pInput must stay valid until End. */
+    void Begin(const char* pInput, const char* pOutput);
+    /** The scene's document info; call at most once. */
+    void Metadata(const char* pTitle, const char* pSubject, const char* pAuthor,
+                  const char* pKeywords, const char* pRevision, const char* pComment);
+
+    void BeginJoint(const char* pName);
+    /** The name was already used and the joint was given pName instead. */
+    void JointUnique(const char* pName);
+    /** pName is the joint map entry, or NULL if the map has none. */
+    void JointRenamed(const char* pName);
+    void JointRootScale(double pScale);
+    void JointType(const char* pType);
+    void JointSize(double pBefore, double pAfter);
+    void EndJoint();
+
+    /** The metadata and joints recorded so far, independent of format and file names. */
+    std::string GetFragment() const;
+    /** Record the metadata and joints of a GetFragment result instead of new events. */
+    void Replay(const std::string& pFragment);
+
+    void End(bool pResult, bool pCached);
+
+    /** The finished record; valid after End. */
+    const std::string& GetText() const { return mJson.GetText(); }
+
+private:
+    JsonWriter mJson;
+    JsonWriter mMetadata;
+    JsonWriter mJoints;     // One object per line.
+    EReportFormat mFormat;
+    const char* mInput;
+    const char* mOutput;
+    int mJointCount;
+    int mActions;
+};
+
+/** Collects the reports of every processed file. Add may be called from
+  * several threads; records of one file always stay together.
+  */
+class RenameReport
+{
+public:
+    explicit RenameReport(EReportFormat pFormat);
+
+    EReportFormat GetFormat() const { return mFormat; }
+
+    void Add(const FileReport& pFile);
+
+    bool Save(const char* pFileName);
+
+private:
+    RenameReport(const RenameReport&);
+    RenameReport& operator=(const RenameReport&);
+
+    EReportFormat mFormat;
+    std::mutex mMutex;
+    std::string mText;
+    int mFiles;
+};
+
+#endif // #ifndef _RENAME_REPORT_H
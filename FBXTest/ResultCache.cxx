@@ -0,0 +1,142 @@
+#include "ResultCache.h"
+#include "Common/FileUtility.h"
+#include "Common/Hash64.h"
+#include "Common/Log.h"
+
+#include <fbxsdk.h>
+
+#include <cstdio>
+#include <cstring>
+
+#if defined(_WIN32)
+    #include <process.h>
+    #define CACHE_PROCESS_ID _getpid()
+#else
+    #include <unistd.h>
+    #define CACHE_PROCESS_ID getpid()
+#endif
+
+// Bump whenever a pipeline change alters the bytes written for the same input
+// and options, so entries made by older builds are no longer found.
+static const int RESULT_CACHE_VERSION = 1;
+
+#ifdef FBXSDK_VERSION_STRING
+    static const char* const CACHE_SDK_VERSION = FBXSDK_VERSION_STRING;
+#else
+    static const char* const CACHE_SDK_VERSION = "unknown";
+#endif
+
+ResultCache::ResultCache()
+    : mHardLink(false)
+    , mHits(0)
+    , mMisses(0)
+    , mNextTemporary(0)
+{
+}
+
+bool ResultCache::Open(const char* pDirectory, bool pHardLink)
+{
+    if (!MakeDirectory(pDirectory))
+        return false;
+    mDirectory = pDirectory;
+    mHardLink = pHardLink;
+    return true;
+}
+
+static bool ReadReport(const std::string& pFileName, std::string& pReport)
+{
+    FILE* lFile = fopen(pFileName.c_str(), "rb");
+    if (!lFile)
+        return false;
+    pReport.clear();
+    char lBuffer[4096];
+    size_t lRead;
+    while ((lRead = fread(lBuffer, 1, sizeof(lBuffer), lFile)) > 0)
+        pReport.append(lBuffer, lRead);
+    const bool lResult = !ferror(lFile);
+    fclose(lFile);
+    return lResult;
+}
+
+static bool WriteReport(const std::string& pFileName, const std::string& pReport)
+{
+    FILE* lFile = fopen(pFileName.c_str(), "wb");
+    if (!lFile)
+        return false;
+    const bool lResult = fwrite(pReport.data(), 1, pReport.size(), lFile) == pReport.size();
+    return fclose(lFile) == 0 && lResult;
+}
+
+std::string ResultCache::GetEntryPath(const std::string& pKey) const
+{
+    return JoinPath(mDirectory, pKey + ".fbx");
+}
+
+std::string ResultCache::MakeKey(const char* pInput, const std::string& pOptionsKey, unsigned long long pJointMapHash) const
+{
+    unsigned long long lInputHash;
+    long long lInputSize;
+    if (!HashFile(pInput, lInputHash, &lInputSize))
+        return std::string();
+
+    char lHeader[128];
+    sprintf(lHeader, "cache %d sdk %s\ninput %s %llu\nmap %s\n", RESULT_CACHE_VERSION, CACHE_SDK_VERSION,
+            FormatHash64(lInputHash).c_str(), (unsigned long long)lInputSize, FormatHash64(pJointMapHash).c_str());
+
+    // Two seeds give a 128 bit name, so unrelated jobs practically never collide.
+    const std::string lText = lHeader + pOptionsKey;
+    return FormatHash64(Hash64(lText, 0)) + FormatHash64(Hash64(lText, 1));
+}
+
+bool ResultCache::Fetch(const std::string& pKey, const char* pOutput, std::string* pReport)
+{
+    const std::string lEntry = GetEntryPath(pKey);
+    if (GetFileSize(lEntry.c_str()) < 0 || (pReport && !ReadReport(lEntry + ".report", *pReport)))
+    {
+        ++mMisses;
+        return false;
+    }
+
+    // Linking fails across volumes; a copy still saves the whole pipeline.
+    if ((mHardLink && MakeHardLink(lEntry.c_str(), pOutput)) || CopyFileContents(lEntry.c_str(), pOutput))
+    {
+        ++mHits;
+        return true;
+    }
+
+    LOG_WARNING("Warning: Unable to copy cached result %s to %s\n", lEntry.c_str(), pOutput);
+    ++mMisses;
+    return false;
+}
+
+void ResultCache::DetachOutput(const char* pInput, const char* pOutput) const
+{
+    if (mHardLink && strcmp(pInput, pOutput) != 0)
+        remove(pOutput);
+}
+
+std::string ResultCache::GetTemporarySuffix()
+{
+    char lSuffix[32];
+    sprintf(lSuffix, ".%d.%d.tmp", (int)CACHE_PROCESS_ID, mNextTemporary++);
+    return lSuffix;
+}
+
+void ResultCache::Store(const std::string& pKey, const char* pOutput, const std::string* pReport)
+{
+    const std::string lEntry = GetEntryPath(pKey);
+
+    // The report goes first, so a hit that asks for it never finds the entry without it.
+    if (pReport)
+    {
+        const std::string lTemporary = lEntry + ".report" + GetTemporarySuffix();
+        if (!WriteReport(lTemporary, *pReport) || rename(lTemporary.c_str(), (lEntry + ".report").c_str()) != 0)
+            remove(lTemporary.c_str());
+    }
+
+    // rename() does not replace an existing file on Windows; if another worker
+    // stored the same key first, its entry is just as good.
+    const std::string lTemporary = lEntry + GetTemporarySuffix();
+    if (!CopyFileContents(pOutput, lTemporary.c_str()) || rename(lTemporary.c_str(), lEntry.c_str()) != 0)
+        remove(lTemporary.c_str());
+}
@@ -0,0 +1,73 @@
+#ifndef _RESULT_CACHE_H
+#define _RESULT_CACHE_H
+
+#include <atomic>
+#include <string>
+
+/** On-disk cache of pipeline outputs, keyed by content.
+  *
+  * A key covers the input file's bytes, the joint map entries, every option
+  * that changes the output, the cache format version and the FBX SDK version,
+  * so a stale entry is never returned after any of them changes. Entries are
+  * plain files named after their key in one directory; deleting the directory
+  * clears the cache.
+  *
+  * All methods may be called from several threads at once. Entries are written
+  * to a per-process temporary name and renamed into place, so concurrent
+  * workers and processes sharing a directory never see partial files.
+  */
+class ResultCache
+{
+public:
+    ResultCache();
+
+    /** Use pDirectory for entries, creating it if needed.
+      * /param pHardLink Hand out hits as hard links instead of copies. Outputs
+      *        must then not be modified in place, or the cached entry changes too.
+      * /return false if the directory cannot be created.
+      */
+    bool Open(const char* pDirectory, bool pHardLink);
+
+    bool IsOpen() const { return !mDirectory.empty(); }
+
+    /** Compute the key of a job; empty if the input cannot be read. */
+    std::string MakeKey(const char* pInput, const std::string& pOptionsKey, unsigned long long pJointMapHash) const;
+
+    /** Copy or link the entry for pKey to pOutput. Counts a hit or a miss.
+      * /param pReport If not NULL, receives the report fragment stored with the
+      *        entry. An entry stored without one is then a miss, so the run that
+      *        follows stores both.
+      * /return true on a hit.
+      */
+    bool Fetch(const std::string& pKey, const char* pOutput, std::string* pReport = NULL);
+
+    /** Before a miss is processed, unlink an output that an earlier hit may have
+      * hard linked to an entry, so writing the new output cannot change the entry.
+      * Does nothing without hard links or when pOutput is the input itself.
+      */
+    void DetachOutput(const char* pInput, const char* pOutput) const;
+
+    /** Add pOutput, the result of a successful run, as the entry for pKey.
+      * /param pReport If not NULL, the run's report fragment (FileReport::GetFragment)
+      *        to hand out with later hits.
+      */
+    void Store(const std::string& pKey, const char* pOutput, const std::string* pReport = NULL);
+
+    int GetHits() const { return mHits; }
+    int GetMisses() const { return mMisses; }
+
+private:
+    ResultCache(const ResultCache&);
+    ResultCache& operator=(const ResultCache&);
+
+    std::string GetEntryPath(const std::string& pKey) const;
+    std::string GetTemporarySuffix();
+
+    std::string mDirectory;
+    bool mHardLink;
+    std::atomic<int> mHits;
+    std::atomic<int> mMisses;
+    std::atomic<int> mNextTemporary;
+};
+
+#endif // #ifndef _RESULT_CACHE_H
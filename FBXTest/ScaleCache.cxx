@@ -0,0 +1,101 @@
+#include "ScaleCache.h"
+
+#include <algorithm>
+
+static bool HasScaleCurve(const SceneTableCurves& pCurves)
+{
+    return pCurves.mScaling[0] || pCurves.mScaling[1] || pCurves.mScaling[2];
+}
+
+void ScaleCache::Build(const SceneTable& pTable, const SceneTableLayer& pLayer)
+{
+    const std::vector<SceneTableNode>& lNodes = pTable.GetNodes();
+    mTimes.clear();
+    mSamples.clear();
+    mNodeSamples.assign(lNodes.size(), -1);
+    mParents.resize(lNodes.size());
+
+    // First pass: find the nodes below an animated scale and gather the times
+    // their translations are keyed at. A marker of 0 stands for "scaled" until
+    // the real sample entries are allocated below.
+    for (size_t i = 0; i < lNodes.size(); ++i)
+    {
+        const int lParent = lNodes[i].mParent;
+        mParents[i] = lParent;
+        if (lParent >= 0 && mNodeSamples[lParent] >= 0)
+        {
+            for (int c = 0; c < 3; ++c)
+            {
+                FbxAnimCurve* lCurve = pLayer.mCurves[i].mTranslation[c];
+                for (int k = 0, lCount = lCurve ? lCurve->KeyGetCount() : 0; k < lCount; ++k)
+                    mTimes.push_back(lCurve->KeyGetTime(k).Get());
+            }
+        }
+        if (HasScaleCurve(pLayer.mCurves[i]) || (lParent >= 0 && mNodeSamples[lParent] >= 0))
+            mNodeSamples[i] = 0;
+    }
+
+    std::sort(mTimes.begin(), mTimes.end());
+    mTimes.erase(std::unique(mTimes.begin(), mTimes.end()), mTimes.end());
+
+    // Second pass, top-down: a node with scale curves gets its own samples, its
+    // parent's samples times its own curves; any other node shares its parent's entry.
+    const size_t lSampleCount = mTimes.size();
+    for (size_t i = 0; i < lNodes.size(); ++i)
+    {
+        if (mNodeSamples[i] < 0)
+            continue;
+
+        const int lParent = mParents[i];
+        const int lParentSamples = lParent >= 0 ? mNodeSamples[lParent] : -1;
+        const SceneTableCurves& lCurves = pLayer.mCurves[i];
+        if (!HasScaleCurve(lCurves) || lSampleCount == 0)
+        {
+            mNodeSamples[i] = lParentSamples;
+            continue;
+        }
+
+        mNodeSamples[i] = (int)mSamples.size();
+        mSamples.push_back(lParentSamples >= 0 ? mSamples[lParentSamples]
+                                               : std::vector<double>(lSampleCount * 3, 1.0));
+        std::vector<double>& lSamples = mSamples.back();
+        for (int c = 0; c < 3; ++c)
+        {
+            FbxAnimCurve* lCurve = lCurves.mScaling[c];
+            if (!lCurve)
+                continue;
+
+            // Times are ascending, so the key index hint makes each evaluation O(1).
+            int lLast = 0;
+            for (size_t t = 0; t < lSampleCount; ++t)
+                lSamples[t * 3 + c] *= lCurve->Evaluate(FbxTime(mTimes[t]), &lLast);
+        }
+    }
+}
+
+bool ScaleCache::HasParentScale(int pNode) const
+{
+    const int lParent = mParents[pNode];
+    return lParent >= 0 && mNodeSamples[lParent] >= 0;
+}
+
+void ScaleCache::GetParentFactors(int pNode, int pComponent, FbxAnimCurve* pCurve, std::vector<float>& pFactors) const
+{
+    const int lKeyCount = pCurve->KeyGetCount();
+    pFactors.assign(lKeyCount, 1.0f);
+    if (!HasParentScale(pNode))
+        return;
+
+    // Keys and sample times are both sorted and every key time is a sample, so
+    // one forward walk finds them all.
+    const std::vector<double>& lSamples = mSamples[mNodeSamples[mParents[pNode]]];
+    size_t t = 0;
+    for (int k = 0; k < lKeyCount; ++k)
+    {
+        const FbxLongLong lTime = pCurve->KeyGetTime(k).Get();
+        while (t < mTimes.size() && mTimes[t] < lTime)
+            ++t;
+        if (t < mTimes.size() && mTimes[t] == lTime)
+            pFactors[k] = (float)lSamples[t * 3 + pComponent];
+    }
+}
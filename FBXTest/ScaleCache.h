@@ -0,0 +1,47 @@
+#ifndef _SCALE_CACHE_H
+#define _SCALE_CACHE_H
+
+#include <fbxsdk.h>
+#include <vector>
+#include "SceneTable.h"
+
+/** Accumulated animated scale of every node of one layer, sampled at the key
+  * times of the translation curves it applies to.
+  *
+  * The sample times are the union of the translation key times of all nodes that
+  * have an animated scale above them. Each scale curve is evaluated at those
+  * times once, walking the table top-down, and multiplied into its parent's
+  * samples. Nodes without scale curves share their parent's samples, so the
+  * cost is one curve evaluation per sample for each scaled node plus one lookup
+  * per translation key.
+  *
+  * Build must run before the scale curves are cleared.
+  */
+class ScaleCache
+{
+public:
+    void Build(const SceneTable& pTable, const SceneTableLayer& pLayer);
+
+    /** Whether any ancestor of node pNode has an animated scale on this layer. */
+    bool HasParentScale(int pNode) const;
+
+    /** Accumulated parent scale of node pNode along pComponent at each key of pCurve.
+      * /param pNode Index into the table's node array.
+      * /param pComponent 0 = X, 1 = Y, 2 = Z.
+      * /param pCurve A translation curve of pNode on this layer.
+      * /param pFactors Receives one factor per key.
+      */
+    void GetParentFactors(int pNode, int pComponent, FbxAnimCurve* pCurve, std::vector<float>& pFactors) const;
+
+    size_t GetSampleCount() const { return mTimes.size(); }
+
+private:
+    std::vector<FbxLongLong> mTimes;
+    // Per node, the entry of mSamples holding its accumulated scale, -1 for none.
+    std::vector<int> mNodeSamples;
+    // Per entry, the X, Y and Z scale interleaved for each of mTimes.
+    std::vector<std::vector<double> > mSamples;
+    std::vector<int> mParents;
+};
+
+#endif // #ifndef _SCALE_CACHE_H
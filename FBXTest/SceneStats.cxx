@@ -0,0 +1,172 @@
+#include "SceneStats.h"
+#include "Common/FileUtility.h"
+#include "Common/Log.h"
+#include "Profile.h"
+
+#include <algorithm>
+#include <stdio.h>
+
+// Approximate SDK memory per object, for the footprint estimate. Nodes carry
+// about a hundred properties; keys are stored with their tangent data.
+static const long long NODE_BYTES = 2048;
+static const long long CURVE_BYTES = 256;
+static const long long KEY_BYTES = 40;
+static const long long CONTROL_POINT_BYTES = 32;
+static const long long POLYGON_VERTEX_BYTES = 48;
+
+static const char* const gAttributeNames[SCENE_STATS_ATTRIBUTE_TYPES] =
+{
+    "none", "null", "marker", "skeleton", "mesh", "nurbs", "patch", "camera",
+    "cameraStereo", "cameraSwitcher", "light", "opticalReference", "opticalMarker",
+    "nurbsCurve", "trimNurbsSurface", "boundary", "nurbsSurface", "shape",
+    "lodGroup", "subdiv", "cachedEffect", "line"
+};
+
+SceneStats::SceneStats()
+    : mFileSize(0)
+    , mUnitToCentimeters(1.0)
+    , mFrameRate(0.0)
+    , mNodes(0)
+    , mHierarchyDepth(0)
+    , mSkeletonDepth(0)
+    , mStacks(0)
+    , mLayers(0)
+    , mCurves(0)
+    , mKeys(0)
+    , mAnimationSeconds(0.0)
+    , mMeshes(0)
+    , mVertices(0)
+    , mPolygonVertices(0)
+    , mEstimatedMemory(0)
+    , mPeakMemory(0)
+{
+    for (int i = 0; i < SCENE_STATS_ATTRIBUTE_TYPES; ++i)
+        mAttributes[i] = 0;
+}
+
+void CollectSceneStats(FbxScene* pScene, const SceneTable& pTable, SceneStats& pStats)
+{
+    FbxGlobalSettings& lSettings = pScene->GetGlobalSettings();
+    pStats.mUnitToCentimeters = lSettings.GetSystemUnit().GetConversionFactorTo(FbxSystemUnit::cm);
+    pStats.mFrameRate = FbxTime::GetFrameRate(lSettings.GetTimeMode());
+
+    // Parents come before children, so depths are filled in one forward pass.
+    // Entry 0 is the scene root, which is not counted.
+    const std::vector<SceneTableNode>& lNodes = pTable.GetNodes();
+    std::vector<int> lDepths(lNodes.size(), 0);
+    std::vector<int> lSkeletonDepths(lNodes.size(), 0);
+    for (size_t i = 1; i < lNodes.size(); ++i)
+    {
+        const SceneTableNode& lNode = lNodes[i];
+        const bool lSkeleton = lNode.mAttributeType == FbxNodeAttribute::eSkeleton;
+        lDepths[i] = lDepths[lNode.mParent] + 1;
+        lSkeletonDepths[i] = lSkeleton ? lSkeletonDepths[lNode.mParent] + 1 : 0;
+        pStats.mHierarchyDepth = std::max(pStats.mHierarchyDepth, lDepths[i]);
+        pStats.mSkeletonDepth = std::max(pStats.mSkeletonDepth, lSkeletonDepths[i]);
+
+        if (lNode.mAttributeType >= 0 && lNode.mAttributeType < SCENE_STATS_ATTRIBUTE_TYPES)
+            ++pStats.mAttributes[lNode.mAttributeType];
+        ++pStats.mNodes;
+    }
+
+    pStats.mStacks = pScene->GetSrcObjectCount<FbxAnimStack>();
+    pStats.mLayers = (int)pTable.GetLayers().size();
+    for (int i = 0; i < pStats.mStacks; ++i)
+        pStats.mAnimationSeconds += pScene->GetSrcObject<FbxAnimStack>(i)->GetLocalTimeSpan().GetDuration().GetSecondDouble();
+
+    pStats.mCurves = pScene->GetSrcObjectCount<FbxAnimCurve>();
+    for (int i = 0; i < pStats.mCurves; ++i)
+        pStats.mKeys += pScene->GetSrcObject<FbxAnimCurve>(i)->KeyGetCount();
+
+    // Meshes are counted as objects, so instances are only counted once.
+    pStats.mMeshes = pScene->GetSrcObjectCount<FbxMesh>();
+    for (int i = 0; i < pStats.mMeshes; ++i)
+    {
+        FbxMesh* lMesh = pScene->GetSrcObject<FbxMesh>(i);
+        pStats.mVertices += lMesh->GetControlPointsCount();
+        pStats.mPolygonVertices += lMesh->GetPolygonVertexCount();
+    }
+
+    pStats.mEstimatedMemory = pStats.mNodes * NODE_BYTES + pStats.mCurves * CURVE_BYTES + pStats.mKeys * KEY_BYTES
+                            + pStats.mVertices * CONTROL_POINT_BYTES + pStats.mPolygonVertices * POLYGON_VERTEX_BYTES;
+}
+
+void WriteSceneStats(JsonWriter& pJson, const SceneStats& pStats)
+{
+    pJson.BeginObject();
+    pJson.Key("input");             pJson.String(pStats.mInput.c_str());
+    pJson.Key("bytes");             pJson.Int(pStats.mFileSize);
+    pJson.Key("unitToCm");          pJson.Double(pStats.mUnitToCentimeters);
+    pJson.Key("frameRate");         pJson.Double(pStats.mFrameRate);
+    pJson.Key("nodes");             pJson.Int(pStats.mNodes);
+    pJson.Key("attributes");
+    pJson.BeginObject();
+    for (int i = 0; i < SCENE_STATS_ATTRIBUTE_TYPES; ++i)
+    {
+        if (pStats.mAttributes[i] == 0)
+            continue;
+        pJson.Key(gAttributeNames[i]);
+        pJson.Int(pStats.mAttributes[i]);
+    }
+    pJson.EndObject();
+    pJson.Key("hierarchyDepth");    pJson.Int(pStats.mHierarchyDepth);
+    pJson.Key("skeletonDepth");     pJson.Int(pStats.mSkeletonDepth);
+    pJson.Key("stacks");            pJson.Int(pStats.mStacks);
+    pJson.Key("layers");            pJson.Int(pStats.mLayers);
+    pJson.Key("curves");            pJson.Int(pStats.mCurves);
+    pJson.Key("keys");              pJson.Int(pStats.mKeys);
+    pJson.Key("animationSeconds");  pJson.Double(pStats.mAnimationSeconds);
+    pJson.Key("keysPerSecond");     pJson.Double(pStats.mAnimationSeconds > 0.0 ? pStats.mKeys / pStats.mAnimationSeconds : 0.0);
+    pJson.Key("meshes");            pJson.Int(pStats.mMeshes);
+    pJson.Key("vertices");          pJson.Int(pStats.mVertices);
+    pJson.Key("polygonVertices");   pJson.Int(pStats.mPolygonVertices);
+    pJson.Key("estimatedMemory");   pJson.Int(pStats.mEstimatedMemory);
+    pJson.Key("peakMemory");        pJson.Int(pStats.mPeakMemory);
+    pJson.EndObject();
+}
+
+bool RunSceneStats(const char* pInput, const ImportOptions& pOptions, const std::string& pReport)
+{
+    // A report on stdout must not be mixed with log output.
+    if (pReport.empty())
+        SetLogStream(stderr);
+
+    FbxManager* lManager = NULL;
+    FbxScene* lScene = NULL;
+    InitializeSdkObjects(lManager, lScene);
+
+    bool lResult = LoadScene(lManager, lScene, pInput, pOptions);
+    if (!lResult)
+    {
+        LOG_ERROR("\n\nAn error occurred while loading %s\n", pInput);
+    }
+    else
+    {
+        SceneTable lTable;
+        lTable.Build(lScene);
+
+        SceneStats lStats;
+        lStats.mInput = pInput;
+        lStats.mFileSize = GetFileSize(pInput);
+        CollectSceneStats(lScene, lTable, lStats);
+        lStats.mPeakMemory = GetPeakMemoryUsage();
+
+        JsonWriter lJson;
+        WriteSceneStats(lJson, lStats);
+        LogFlush();
+        if (pReport.empty())
+        {
+            fwrite(lJson.GetText().c_str(), 1, lJson.GetText().size(), stdout);
+            fputc('\n', stdout);
+        }
+        else if (!lJson.Save(pReport.c_str()))
+        {
+            LOG_ERROR("Error: Unable to write stats report %s\n", pReport.c_str());
+            lResult = false;
+        }
+    }
+
+    DestroySdkObjects(lManager, lResult);
+    LogFlush();
+    return lResult;
+}
@@ -0,0 +1,59 @@
+#ifndef _SCENE_STATS_H
+#define _SCENE_STATS_H
+
+#include <fbxsdk.h>
+#include "SceneTable.h"
+#include "Common/Common.h"
+#include "Common/JsonWriter.h"
+
+#include <string>
+
+// One counter per FbxNodeAttribute::EType, up to eLine.
+#define SCENE_STATS_ATTRIBUTE_TYPES (FbxNodeAttribute::eLine + 1)
+
+/** Size and content of one loaded scene, for capacity planning. */
+struct SceneStats
+{
+    SceneStats();
+
+    std::string mInput;
+    long long mFileSize;
+    double mUnitToCentimeters;
+    double mFrameRate;
+
+    int mNodes;
+    int mAttributes[SCENE_STATS_ATTRIBUTE_TYPES];
+    int mHierarchyDepth;
+    int mSkeletonDepth;         // Longest chain of skeleton nodes.
+
+    int mStacks;
+    int mLayers;
+    int mCurves;
+    long long mKeys;
+    double mAnimationSeconds;   // Summed over stacks.
+
+    int mMeshes;
+    long long mVertices;        // Control points of all meshes.
+    long long mPolygonVertices;
+
+    long long mEstimatedMemory; // Rough SDK memory for the content above, in bytes.
+    long long mPeakMemory;      // Process peak after loading.
+};
+
+/** Fill pStats from a loaded scene in one pass over its table and object lists. */
+void CollectSceneStats(FbxScene* pScene, const SceneTable& pTable, SceneStats& pStats);
+
+/** Append pStats to pJson as one object. */
+void WriteSceneStats(JsonWriter& pJson, const SceneStats& pStats);
+
+/** Load a file, report its statistics as JSON and write nothing else.
+  * Content and take options are honored, so the numbers match what a
+  * pipeline run with the same options would load.
+  * /param pInput The FBX file to inspect.
+  * /param pOptions Import options.
+  * /param pReport JSON file to write; empty prints to stdout.
+  * /return false if the file cannot be loaded or the report cannot be written.
+  */
+bool RunSceneStats(const char* pInput, const ImportOptions& pOptions, const std::string& pReport);
+
+#endif // #ifndef _SCENE_STATS_H
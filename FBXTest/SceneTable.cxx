@@ -0,0 +1,81 @@
+#include "SceneTable.h"
+
+static const char* const gComponents[3] =
+{
+    FBXSDK_CURVENODE_COMPONENT_X, FBXSDK_CURVENODE_COMPONENT_Y, FBXSDK_CURVENODE_COMPONENT_Z
+};
+
+void SceneTable::Build(FbxScene* pScene)
+{
+    mNodes.clear();
+    mLayers.clear();
+
+    FbxNode* lRoot = pScene->GetRootNode();
+    if (!lRoot)
+        return;
+
+    mNodes.reserve(pScene->GetNodeCount());
+
+    // Explicit stack of (node, parent index); children are pushed in reverse so
+    // they come out in the same order the recursive walks used to visit them.
+    std::vector<std::pair<FbxNode*, int> > lStack;
+    lStack.push_back(std::make_pair(lRoot, -1));
+    while (!lStack.empty())
+    {
+        FbxNode* lNode = lStack.back().first;
+        int lParent = lStack.back().second;
+        lStack.pop_back();
+
+        SceneTableNode lEntry;
+        lEntry.mNode = lNode;
+        lEntry.mParent = lParent;
+        lEntry.mAttributeType = lNode->GetNodeAttribute() ? lNode->GetNodeAttribute()->GetAttributeType()
+                                                          : FbxNodeAttribute::eUnknown;
+        const int lIndex = (int)mNodes.size();
+        mNodes.push_back(lEntry);
+
+        for (int i = lNode->GetChildCount() - 1; i >= 0; --i)
+        {
+            lStack.push_back(std::make_pair(lNode->GetChild(i), lIndex));
+        }
+    }
+
+    int lStackCount = pScene->GetSrcObjectCount<FbxAnimStack>();
+    for (int i = 0; i < lStackCount; ++i)
+    {
+        FbxAnimStack* lAnimStack = pScene->GetSrcObject<FbxAnimStack>(i);
+        int lLayerCount = lAnimStack->GetMemberCount<FbxAnimLayer>();
+        for (int j = 0; j < lLayerCount; ++j)
+        {
+            BuildLayer(lAnimStack, lAnimStack->GetMember<FbxAnimLayer>(j));
+        }
+    }
+}
+
+void SceneTable::BuildLayer(FbxAnimStack* pStack, FbxAnimLayer* pLayer)
+{
+    mLayers.push_back(SceneTableLayer());
+    SceneTableLayer& lLayer = mLayers.back();
+    lLayer.mStack = pStack;
+    lLayer.mLayer = pLayer;
+    lLayer.mAnimatedNodes = 0;
+    lLayer.mCurves.resize(mNodes.size());
+
+    for (size_t i = 0; i < mNodes.size(); ++i)
+    {
+        FbxNode* lNode = mNodes[i].mNode;
+        SceneTableCurves& lCurves = lLayer.mCurves[i];
+
+        // Most nodes are not animated on a given layer; checking for the curve
+        // node first avoids three channel lookups per property for them.
+        const bool lTranslated = lNode->LclTranslation.GetCurveNode(pLayer) != NULL;
+        const bool lScaled = lNode->LclScaling.GetCurveNode(pLayer) != NULL;
+        for (int c = 0; c < 3; ++c)
+        {
+            lCurves.mTranslation[c] = lTranslated ? lNode->LclTranslation.GetCurve(pLayer, gComponents[c]) : NULL;
+            lCurves.mScaling[c] = lScaled ? lNode->LclScaling.GetCurve(pLayer, gComponents[c]) : NULL;
+        }
+        if (lTranslated || lScaled)
+            ++lLayer.mAnimatedNodes;
+    }
+}
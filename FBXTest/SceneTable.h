@@ -0,0 +1,56 @@
+#ifndef _SCENE_TABLE_H
+#define _SCENE_TABLE_H
+
+#include <fbxsdk.h>
+#include <vector>
+
+/** One node of the flattened hierarchy. */
+struct SceneTableNode
+{
+    FbxNode* mNode;
+    int mParent;                                // Index into the node array, -1 for the scene root.
+    FbxNodeAttribute::EType mAttributeType;     // eUnknown for nodes without an attribute.
+};
+
+/** Translation and scaling curves of one node on one layer, indexed by component
+  * (0 = X, 1 = Y, 2 = Z). NULL where the component is not animated.
+  */
+struct SceneTableCurves
+{
+    FbxAnimCurve* mTranslation[3];
+    FbxAnimCurve* mScaling[3];
+};
+
+/** One animation layer with the curves of every node, parallel to the node array. */
+struct SceneTableLayer
+{
+    FbxAnimStack* mStack;
+    FbxAnimLayer* mLayer;
+    std::vector<SceneTableCurves> mCurves;
+    int mAnimatedNodes;                         // Nodes with at least one curve on this layer.
+};
+
+/** The node hierarchy of a scene flattened once, in depth first pre-order, so
+  * every parent comes before its children. Passes over the scene iterate the
+  * arrays instead of recursing through FbxNode::GetChild, which keeps deep rigs
+  * off the call stack and looks up each animation curve only once.
+  *
+  * Entry 0 is the scene root node. The table holds raw SDK pointers and must be
+  * rebuilt after nodes, stacks or layers are added or removed.
+  */
+class SceneTable
+{
+public:
+    void Build(FbxScene* pScene);
+
+    const std::vector<SceneTableNode>& GetNodes() const { return mNodes; }
+    const std::vector<SceneTableLayer>& GetLayers() const { return mLayers; }
+
+private:
+    void BuildLayer(FbxAnimStack* pStack, FbxAnimLayer* pLayer);
+
+    std::vector<SceneTableNode> mNodes;
+    std::vector<SceneTableLayer> mLayers;
+};
+
+#endif // #ifndef _SCENE_TABLE_H
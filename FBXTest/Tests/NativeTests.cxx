@@ -0,0 +1,575 @@
+// SDK-free tests of the native binary FBX code: reader, patch plan, inflater,
+// curve scaler and renamer. Fixtures are built in memory for FBX 7.4 and 7.5
+// with the SDK's footer layout; every pass is checked against a fixture built
+// directly with the expected names and values, byte for byte.
+
+#include "../Native/Inflate.h"
+#include "../Native/NativeFbxReader.h"
+#include "../Native/NativeRenamer.h"
+#include "../Common/FileUtility.h"
+#include "../Common/Log.h"
+#include "../JointMap.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+typedef std::vector<unsigned char> Bytes;
+
+static int gFailures = 0;
+
+#define CHECK(condition) Check((condition), #condition, __FILE__, __LINE__)
+
+static bool Check(bool pOk, const char* pText, const char* pFile, int pLine)
+{
+    if (!pOk)
+    {
+        fprintf(stderr, "%s:%d: CHECK failed: %s\n", pFile, pLine, pText);
+        ++gFailures;
+    }
+    return pOk;
+}
+
+// 37 floats i * 0.25, compressed by zlib with dynamic Huffman codes.
+static const unsigned char VALUES_DYNAMIC[] =
+{
+    0x78, 0xda, 0x15, 0xc4, 0xa1, 0x15, 0x82, 0x50, 0x00, 0x86, 0xd1, 0x3f, 0x10, 0x0c, 0x06, 0x46,
+    0x60, 0x04, 0x27, 0xd0, 0xc7, 0x06, 0x8e, 0xc0, 0x08, 0x8e, 0xf0, 0xa2, 0xd1, 0x68, 0x24, 0x1a,
+    0x8d, 0x44, 0x22, 0x91, 0x68, 0x24, 0x1a, 0x8d, 0x46, 0xaf, 0xdf, 0x39, 0xf7, 0x4b, 0xfe, 0xd5,
+    0xa3, 0x9d, 0x92, 0x42, 0x65, 0x64, 0x66, 0x23, 0x25, 0x69, 0xe9, 0x38, 0x50, 0x38, 0x33, 0x70,
+    0xa1, 0x72, 0xe5, 0xc6, 0x9d, 0x91, 0x07, 0x4f, 0x26, 0x66, 0x16, 0x56, 0x5e, 0x6c, 0xbc, 0xf9,
+    0xf0, 0x25, 0x7d, 0xd2, 0xb0, 0x63, 0x4f, 0xdb, 0xff, 0x00, 0x15, 0x06, 0x1a, 0x26,
+};
+static const unsigned int VALUE_COUNT = 37;
+
+// Two key attributes of four floats 1.5, compressed with fixed Huffman codes.
+static const unsigned char ATTRIBUTES_FIXED[] =
+{
+    0x78, 0xda, 0x63, 0x60, 0x38, 0x60, 0xcf, 0x80, 0x07, 0x03, 0x00, 0x7d, 0xa8, 0x07, 0xf9,
+};
+static const unsigned int ATTRIBUTE_COUNT = 8;
+
+static const unsigned char FOOTER_ID[16] =
+{
+    0xfa, 0xbc, 0xab, 0x09, 0xd0, 0xc8, 0xd4, 0x66, 0xb1, 0x76, 0xfb, 0x83, 0x1c, 0xf7, 0x26, 0x7e
+};
+static const unsigned char FOOTER_MAGIC[16] =
+{
+    0xf8, 0x5a, 0x8c, 0x6a, 0xde, 0xf5, 0xd9, 0x7e, 0xec, 0xe9, 0x0c, 0xe3, 0x75, 0x8f, 0x29, 0x0b
+};
+
+static const char* const OUTPUT_DIRECTORY = "NativeTestsOutput";
+
+/** Writes a binary FBX file the way the SDK lays it out. Records are opened with
+  * Begin, given properties, optionally children, and closed with End.
+  */
+class FixtureWriter
+{
+public:
+    explicit FixtureWriter(unsigned int pVersion)
+        : mVersion(pVersion)
+    {
+        static const char HEADER[] = "Kaydara FBX Binary  \0\x1a\0";
+        mData.assign(HEADER, HEADER + sizeof(HEADER) - 1);
+        Append(&pVersion, 4);
+    }
+
+    void Begin(const char* pName)
+    {
+        if (!mOpen.empty())
+            EndProperties();
+
+        Open lOpen;
+        lOpen.mHeader = mData.size();
+        lOpen.mProperties = 0;
+        lOpen.mPropertyLength = 0;
+        lOpen.mHasChildren = false;
+        mData.resize(mData.size() + HeaderSize() - 1, 0);
+        mData.push_back((unsigned char)strlen(pName));
+        Append(pName, strlen(pName));
+        lOpen.mPropertyStart = mData.size();
+        mOpen.push_back(lOpen);
+    }
+
+    void Int(int pValue) { Code('I'); Append(&pValue, 4); }
+    void Long(long long pValue) { Code('L'); Append(&pValue, 8); }
+    void Double(double pValue) { Code('D'); Append(&pValue, 8); }
+    void String(const std::string& pValue)
+    {
+        Code('S');
+        unsigned int lLength = (unsigned int)pValue.size();
+        Append(&lLength, 4);
+        Append(pValue.data(), pValue.size());
+    }
+    void Floats(const std::vector<float>& pValues)
+    {
+        Code('f');
+        unsigned int lHeader[3] = { (unsigned int)pValues.size(), 0, (unsigned int)pValues.size() * 4 };
+        Append(lHeader, sizeof(lHeader));
+        Append(pValues.data(), pValues.size() * 4);
+    }
+    void CompressedFloats(unsigned int pCount, const unsigned char* pData, size_t pSize)
+    {
+        Code('f');
+        unsigned int lHeader[3] = { pCount, 1, (unsigned int)pSize };
+        Append(lHeader, sizeof(lHeader));
+        Append(pData, pSize);
+    }
+
+    void End()
+    {
+        Open& lOpen = mOpen.back();
+        if (!lOpen.mHasChildren)
+            lOpen.mPropertyLength = mData.size() - lOpen.mPropertyStart;
+        else
+            mData.resize(mData.size() + HeaderSize(), 0);
+
+        unsigned long long lValues[3] = { mData.size(), lOpen.mProperties, lOpen.mPropertyLength };
+        for (int i = 0; i < 3; ++i)
+        {
+            if (mVersion >= 7500)
+                memcpy(&mData[lOpen.mHeader + i * 8], &lValues[i], 8);
+            else
+            {
+                unsigned int lValue = (unsigned int)lValues[i];
+                memcpy(&mData[lOpen.mHeader + i * 4], &lValue, 4);
+            }
+        }
+        mOpen.pop_back();
+    }
+
+    /** The top-level null record and the footer: id, 4 zero bytes, padding that
+      * 16 byte aligns the version, version, 120 zero bytes and the magic.
+      */
+    Bytes Finish()
+    {
+        mData.resize(mData.size() + HeaderSize(), 0);
+        Append(FOOTER_ID, sizeof(FOOTER_ID));
+        mData.resize(mData.size() + 4, 0);
+        size_t lPadding = ((mData.size() + 15) & ~(size_t)15) - mData.size();
+        mData.resize(mData.size() + (lPadding == 0 ? 16 : lPadding), 0);
+        Append(&mVersion, 4);
+        mData.resize(mData.size() + 120, 0);
+        Append(FOOTER_MAGIC, sizeof(FOOTER_MAGIC));
+        return mData;
+    }
+
+private:
+    struct Open
+    {
+        size_t mHeader;
+        size_t mPropertyStart;
+        size_t mPropertyLength;
+        unsigned int mProperties;
+        bool mHasChildren;
+    };
+
+    size_t HeaderSize() const { return mVersion >= 7500 ? 25 : 13; }
+
+    void EndProperties()
+    {
+        Open& lParent = mOpen.back();
+        if (!lParent.mHasChildren)
+        {
+            lParent.mPropertyLength = mData.size() - lParent.mPropertyStart;
+            lParent.mHasChildren = true;
+        }
+    }
+
+    void Code(char pType)
+    {
+        mData.push_back((unsigned char)pType);
+        ++mOpen.back().mProperties;
+    }
+
+    void Append(const void* pData, size_t pSize)
+    {
+        mData.insert(mData.end(), (const unsigned char*)pData, (const unsigned char*)pData + pSize);
+    }
+
+    unsigned int mVersion;
+    Bytes mData;
+    std::vector<Open> mOpen;
+};
+
+/** Two joints with a translated child, a mesh, and a translation and a scaling
+  * curve with a key value and a key attribute array each.
+  */
+struct SceneSpec
+{
+    SceneSpec(unsigned int pVersion)
+        : mVersion(pVersion), mRoot("J0"), mChild("J1"), mScale(1.0), mCompressed(false) {}
+
+    unsigned int mVersion;
+    std::string mRoot;
+    std::string mChild;
+    // Translations as the native scaler writes them.
+    double mScale;
+    // Key arrays zlib compressed. Scaled translation curves are written back
+    // uncompressed, so they are only compressed with a scale of 1.
+    bool mCompressed;
+};
+
+static std::vector<float> Values(float pScale)
+{
+    std::vector<float> lValues;
+    for (unsigned int i = 0; i < VALUE_COUNT; ++i)
+        lValues.push_back(i * 0.25f * pScale);
+    return lValues;
+}
+
+static std::vector<float> Attributes(float pScale)
+{
+    std::vector<float> lAttributes;
+    for (unsigned int i = 0; i < ATTRIBUTE_COUNT; ++i)
+        lAttributes.push_back(i % 4 < 2 ? 1.5f * pScale : 1.5f);
+    return lAttributes;
+}
+
+static void WriteProperty(FixtureWriter& pWriter, const char* pName, const char* pType, double pX, double pY, double pZ)
+{
+    pWriter.Begin("P");
+    pWriter.String(pName); pWriter.String(pType); pWriter.String(""); pWriter.String("A");
+    pWriter.Double(pX); pWriter.Double(pY); pWriter.Double(pZ);
+    pWriter.End();
+}
+
+static void WriteModel(FixtureWriter& pWriter, long long pId, const std::string& pName, const char* pType, double pScale)
+{
+    pWriter.Begin("Model");
+    pWriter.Long(pId); pWriter.String(pName + std::string("\0\1Model", 7)); pWriter.String(pType);
+    pWriter.Begin("Version"); pWriter.Int(232); pWriter.End();
+    pWriter.Begin("Properties70");
+    WriteProperty(pWriter, "Lcl Translation", "Lcl Translation", 1.0 * pScale, 2.0 * pScale, 3.0 * pScale);
+    WriteProperty(pWriter, "Lcl Scaling", "Lcl Scaling", 1.0, 1.0, 1.0);
+    pWriter.End();
+    pWriter.End();
+}
+
+static void WriteCurveNode(FixtureWriter& pWriter, long long pId, const char* pName, double pValue)
+{
+    pWriter.Begin("AnimationCurveNode");
+    pWriter.Long(pId); pWriter.String(std::string(pName) + std::string("\0\1AnimCurveNode", 15)); pWriter.String("");
+    pWriter.Begin("Properties70");
+    pWriter.Begin("P");
+    pWriter.String("d|X"); pWriter.String("Number"); pWriter.String(""); pWriter.String("A"); pWriter.Double(pValue);
+    pWriter.End();
+    pWriter.End();
+    pWriter.End();
+}
+
+static void WriteCurve(FixtureWriter& pWriter, long long pId, double pScale, bool pCompressed)
+{
+    pWriter.Begin("AnimationCurve");
+    pWriter.Long(pId); pWriter.String(std::string("\0\1AnimCurve", 11)); pWriter.String("");
+    pWriter.Begin("Default"); pWriter.Double(4.0 * pScale); pWriter.End();
+    pWriter.Begin("KeyVer"); pWriter.Int(4009); pWriter.End();
+    pWriter.Begin("KeyValueFloat");
+    if (pCompressed)
+        pWriter.CompressedFloats(VALUE_COUNT, VALUES_DYNAMIC, sizeof(VALUES_DYNAMIC));
+    else
+        pWriter.Floats(Values((float)pScale));
+    pWriter.End();
+    pWriter.Begin("KeyAttrDataFloat");
+    if (pCompressed)
+        pWriter.CompressedFloats(ATTRIBUTE_COUNT, ATTRIBUTES_FIXED, sizeof(ATTRIBUTES_FIXED));
+    else
+        pWriter.Floats(Attributes((float)pScale));
+    pWriter.End();
+    pWriter.End();
+}
+
+static void WriteConnection(FixtureWriter& pWriter, const char* pKind, long long pChild, long long pParent, const char* pProperty)
+{
+    pWriter.Begin("C");
+    pWriter.String(pKind); pWriter.Long(pChild); pWriter.Long(pParent);
+    if (pProperty)
+        pWriter.String(pProperty);
+    pWriter.End();
+}
+
+static Bytes BuildScene(const SceneSpec& pSpec)
+{
+    FixtureWriter lWriter(pSpec.mVersion);
+    lWriter.Begin("FBXHeaderExtension");
+    lWriter.Begin("FBXVersion"); lWriter.Int((int)pSpec.mVersion); lWriter.End();
+    lWriter.End();
+
+    lWriter.Begin("Objects");
+    WriteModel(lWriter, 100, pSpec.mRoot, "LimbNode", pSpec.mScale);
+    WriteModel(lWriter, 101, pSpec.mChild, "LimbNode", pSpec.mScale);
+    WriteModel(lWriter, 102, "J2", "Mesh", pSpec.mScale);
+    WriteCurveNode(lWriter, 500, "T", 4.0 * pSpec.mScale);
+    WriteCurveNode(lWriter, 501, "S", 1.0);
+    WriteCurve(lWriter, 600, pSpec.mScale, pSpec.mCompressed && pSpec.mScale == 1.0);
+    WriteCurve(lWriter, 601, 1.0, pSpec.mCompressed);
+    lWriter.End();
+
+    lWriter.Begin("Connections");
+    WriteConnection(lWriter, "OO", 100, 0, NULL);
+    WriteConnection(lWriter, "OO", 101, 100, NULL);
+    WriteConnection(lWriter, "OO", 102, 100, NULL);
+    WriteConnection(lWriter, "OP", 500, 101, "Lcl Translation");
+    WriteConnection(lWriter, "OP", 501, 100, "Lcl Scaling");
+    WriteConnection(lWriter, "OP", 600, 500, "d|X");
+    WriteConnection(lWriter, "OP", 601, 501, "d|X");
+    lWriter.End();
+    return lWriter.Finish();
+}
+
+static std::string OutputPath(const char* pName, unsigned int pVersion)
+{
+    char lName[128];
+    sprintf(lName, "%s_%u.fbx", pName, pVersion);
+    return JoinPath(OUTPUT_DIRECTORY, lName);
+}
+
+static bool WriteBytes(const std::string& pFileName, const Bytes& pData)
+{
+    FILE* lFile = fopen(pFileName.c_str(), "wb");
+    if (!lFile)
+        return false;
+    bool lResult = fwrite(pData.data(), 1, pData.size(), lFile) == pData.size();
+    return fclose(lFile) == 0 && lResult;
+}
+
+static Bytes ReadBytes(const std::string& pFileName)
+{
+    Bytes lData;
+    FILE* lFile = fopen(pFileName.c_str(), "rb");
+    if (!lFile)
+        return lData;
+    unsigned char lBuffer[4096];
+    size_t lRead;
+    while ((lRead = fread(lBuffer, 1, sizeof(lBuffer), lFile)) > 0)
+        lData.insert(lData.end(), lBuffer, lBuffer + lRead);
+    fclose(lFile);
+    return lData;
+}
+
+static bool LoadMap(JointMap& pMap, const char* pEntries)
+{
+    const std::string lFileName = JoinPath(OUTPUT_DIRECTORY, "jointmap.cfg");
+    return WriteBytes(lFileName, Bytes(pEntries, pEntries + strlen(pEntries))) && pMap.Load(lFileName.c_str());
+}
+
+static bool HasTemporaryFiles()
+{
+    std::vector<std::string> lFiles;
+    ListDirectory(OUTPUT_DIRECTORY, lFiles);
+    for (size_t i = 0; i < lFiles.size(); ++i)
+    {
+        if (lFiles[i].find(".tmp") != std::string::npos)
+            return true;
+    }
+    return false;
+}
+
+static void TestReader(unsigned int pVersion)
+{
+    const std::string lInput = OutputPath("reader", pVersion);
+    CHECK(WriteBytes(lInput, BuildScene(SceneSpec(pVersion))));
+
+    NativeFbxReader lReader;
+    if (!CHECK(lReader.Open(lInput.c_str())))
+        return;
+    CHECK(lReader.GetVersion() == pVersion);
+
+    const std::vector<NativeModel>& lModels = lReader.GetModels();
+    if (!CHECK(lModels.size() == 3))
+        return;
+    CHECK(lModels[0].mName.Equals("J0") && lModels[0].IsSkeleton() && lModels[0].mParent == -1);
+    CHECK(lModels[1].mName.Equals("J1") && lModels[1].IsSkeleton() && lModels[1].mParent == 0);
+    CHECK(lModels[2].mName.Equals("J2") && !lModels[2].IsSkeleton() && lModels[2].mParent == 0);
+    CHECK(lReader.GetConnections().size() == 7);
+    CHECK(lReader.GetFooterOffset() > 0);
+
+    std::vector<NativeProperty> lProperties;
+    int lCurve = lReader.FindChild(lReader.FindChild(-1, "Objects"), "AnimationCurve");
+    int lValues = lReader.FindChild(lCurve, "KeyValueFloat");
+    CHECK(lReader.GetProperties(lValues, lProperties) && lProperties.size() == 1 &&
+          lProperties[0].mType == 'f' && lProperties[0].mArrayLength == VALUE_COUNT && lProperties[0].mEncoding == 0);
+}
+
+static void TestCorruptLength(unsigned int pVersion)
+{
+    // A property list length that wraps the offset arithmetic must not pass the bound check.
+    Bytes lData = BuildScene(SceneSpec(pVersion));
+    const size_t lLengthOffset = 27 + (pVersion >= 7500 ? 16 : 8);
+    if (pVersion >= 7500)
+    {
+        unsigned long long lLength = ~0ull - 8;
+        memcpy(&lData[lLengthOffset], &lLength, 8);
+    }
+    else
+    {
+        unsigned int lLength = ~0u - 8;
+        memcpy(&lData[lLengthOffset], &lLength, 4);
+    }
+
+    NativeFbxReader lReader;
+    CHECK(!lReader.Parse(lData.data(), lData.size()));
+}
+
+static void TestInflate()
+{
+    std::vector<float> lValues = Values(1.0f);
+    std::vector<float> lOutput(VALUE_COUNT);
+    CHECK(InflateZlib(VALUES_DYNAMIC, sizeof(VALUES_DYNAMIC), (unsigned char*)lOutput.data(), VALUE_COUNT * 4));
+    CHECK(lOutput == lValues);
+
+    std::vector<float> lAttributes(ATTRIBUTE_COUNT);
+    CHECK(InflateZlib(ATTRIBUTES_FIXED, sizeof(ATTRIBUTES_FIXED), (unsigned char*)lAttributes.data(), ATTRIBUTE_COUNT * 4));
+    CHECK(lAttributes == Attributes(1.0f));
+
+    // A stored block: header, final block type 0, length and its complement, data, Adler-32.
+    const unsigned char lText[] = { 'F', 'B', 'X' };
+    const unsigned char lStored[] = { 0x78, 0x01, 0x01, 0x03, 0x00, 0xfc, 0xff, 'F', 'B', 'X', 0x01, 0xb1, 0x00, 0xe1 };
+    unsigned char lDecoded[3];
+    CHECK(InflateZlib(lStored, sizeof(lStored), lDecoded, sizeof(lDecoded)) && memcmp(lDecoded, lText, 3) == 0);
+
+    // A wrong checksum, a wrong size and a truncated stream are all rejected.
+    unsigned char lBad[sizeof(VALUES_DYNAMIC)];
+    memcpy(lBad, VALUES_DYNAMIC, sizeof(lBad));
+    lBad[sizeof(lBad) - 1] ^= 1;
+    CHECK(!InflateZlib(lBad, sizeof(lBad), (unsigned char*)lOutput.data(), VALUE_COUNT * 4));
+    CHECK(!InflateZlib(VALUES_DYNAMIC, sizeof(VALUES_DYNAMIC), (unsigned char*)lOutput.data(), VALUE_COUNT * 4 - 4));
+    CHECK(!InflateZlib(VALUES_DYNAMIC, sizeof(VALUES_DYNAMIC) / 2, (unsigned char*)lOutput.data(), VALUE_COUNT * 4));
+}
+
+/** Rename pInput to pOutput and compare the result with pExpected. */
+static void CheckRename(const SceneSpec& pInput, const SceneSpec& pExpected, const char* pMap, double pScale,
+                        const char* pName, bool pSamePath, bool pInPlace)
+{
+    const std::string lInput = OutputPath(pName, pInput.mVersion);
+    const std::string lOutput = pSamePath ? lInput : OutputPath((std::string(pName) + "_out").c_str(), pInput.mVersion);
+    CHECK(WriteBytes(lInput, BuildScene(pInput)));
+
+    JointMap lMap;
+    CHECK(LoadMap(lMap, pMap));
+    NativeRenameResult lResult;
+    if (!CHECK(RenameNative(lInput.c_str(), lOutput.c_str(), lMap, pScale, &lResult)))
+        return;
+
+    const Bytes lExpected = BuildScene(pExpected);
+    const Bytes lWritten = ReadBytes(lOutput);
+    CHECK(lWritten.size() == lExpected.size());
+    CHECK(lWritten == lExpected);
+    CHECK(lResult.mInPlace == pInPlace);
+    CHECK(!HasTemporaryFiles());
+
+    // The output must index cleanly on its own, footer included.
+    NativeFbxReader lReader;
+    CHECK(lReader.Open(lOutput.c_str()));
+}
+
+static void TestRenameSameLength(unsigned int pVersion)
+{
+    SceneSpec lExpected(pVersion);
+    lExpected.mRoot = "K0";
+    lExpected.mChild = "K1";
+    // J2 is a mesh, so its entry must not apply.
+    CheckRename(SceneSpec(pVersion), lExpected, "J0=K0\nJ1=K1\nJ2=K2\n", 1.0, "same_length", false, false);
+    CheckRename(SceneSpec(pVersion), lExpected, "J0=K0\nJ1=K1\nJ2=K2\n", 1.0, "in_place", true, true);
+}
+
+static void TestRenameChangedLength(unsigned int pVersion)
+{
+    // One name grows and one shrinks, so offsets move both ways and the footer
+    // padding has to be recomputed.
+    SceneSpec lExpected(pVersion);
+    lExpected.mRoot = "R";
+    lExpected.mChild = "Joint_1_Longer_Name";
+    CheckRename(SceneSpec(pVersion), lExpected, "J0=R\nJ1=Joint_1_Longer_Name\n", 1.0, "changed_length", false, false);
+    CheckRename(SceneSpec(pVersion), lExpected, "J0=R\nJ1=Joint_1_Longer_Name\n", 1.0, "changed_length_same_path", true, false);
+
+    // Every growth from 1 to 16 bytes, to cover each footer padding.
+    for (int lGrowth = 1; lGrowth <= 16; ++lGrowth)
+    {
+        lExpected.mRoot = "J0";
+        lExpected.mChild = "J1" + std::string(lGrowth, 'x');
+        const std::string lMap = "J1=" + lExpected.mChild + "\n";
+        CheckRename(SceneSpec(pVersion), lExpected, lMap.c_str(), 1.0, "padding", false, false);
+    }
+}
+
+static void TestScale(unsigned int pVersion)
+{
+    SceneSpec lInput(pVersion);
+    SceneSpec lExpected(pVersion);
+    lExpected.mScale = 2.5;
+    CheckRename(lInput, lExpected, "", 2.5, "scale", false, false);
+    // Uncompressed arrays keep their size, so the file is patched in place.
+    CheckRename(lInput, lExpected, "", 2.5, "scale_in_place", true, true);
+
+    // Compressed translation arrays are inflated; the scaling curve stays compressed.
+    lInput.mCompressed = true;
+    lExpected.mCompressed = true;
+    lExpected.mChild = "Joint_1_Longer_Name";
+    CheckRename(lInput, lExpected, "J1=Joint_1_Longer_Name\n", 2.5, "scale_compressed", false, false);
+    CheckRename(lInput, lExpected, "J1=Joint_1_Longer_Name\n", 2.5, "scale_compressed_same_path", true, false);
+}
+
+static void TestScaleCorrupt(unsigned int pVersion)
+{
+    // A corrupt compressed translation array fails the whole file before anything is written.
+    SceneSpec lSpec(pVersion);
+    lSpec.mCompressed = true;
+    Bytes lData = BuildScene(lSpec);
+    Bytes::iterator lBlob = std::search(lData.begin(), lData.end(), VALUES_DYNAMIC, VALUES_DYNAMIC + sizeof(VALUES_DYNAMIC));
+    if (!CHECK(lBlob != lData.end()))
+        return;
+    lBlob[20] ^= 0x55;
+
+    const std::string lInput = OutputPath("corrupt", pVersion);
+    const std::string lOutput = OutputPath("corrupt_out", pVersion);
+    CHECK(WriteBytes(lInput, lData));
+    remove(lOutput.c_str());
+
+    JointMap lMap;
+    CHECK(LoadMap(lMap, "J1=Joint_1_Longer_Name\n"));
+    CHECK(!RenameNative(lInput.c_str(), lOutput.c_str(), lMap, 2.5));
+    CHECK(GetFileSize(lOutput.c_str()) < 0);
+
+    CHECK(!RenameNative(lInput.c_str(), lInput.c_str(), lMap, 2.5));
+    CHECK(ReadBytes(lInput) == lData);
+    CHECK(!HasTemporaryFiles());
+}
+
+static void Run(const char* pName, void (*pTest)(unsigned int), unsigned int pVersion)
+{
+    const int lFailures = gFailures;
+    pTest(pVersion);
+    printf("%-24s FBX %u  %s\n", pName, pVersion, gFailures == lFailures ? "ok" : "FAILED");
+}
+
+int main()
+{
+    // Expected failures log errors; the checks report what matters.
+    SetLogLevel(eLogSilent);
+    if (!MakeDirectory(OUTPUT_DIRECTORY))
+    {
+        fprintf(stderr, "Unable to create %s\n", OUTPUT_DIRECTORY);
+        return 1;
+    }
+
+    const int lInflateFailures = gFailures;
+    TestInflate();
+    printf("%-24s          %s\n", "Inflate", gFailures == lInflateFailures ? "ok" : "FAILED");
+
+    const unsigned int lVersions[] = { 7400, 7500 };
+    for (size_t i = 0; i < sizeof(lVersions) / sizeof(lVersions[0]); ++i)
+    {
+        Run("Reader", TestReader, lVersions[i]);
+        Run("CorruptLength", TestCorruptLength, lVersions[i]);
+        Run("RenameSameLength", TestRenameSameLength, lVersions[i]);
+        Run("RenameChangedLength", TestRenameChangedLength, lVersions[i]);
+        Run("Scale", TestScale, lVersions[i]);
+        Run("ScaleCorrupt", TestScaleCorrupt, lVersions[i]);
+    }
+
+    printf("\n%s: %d failed checks\n", gFailures == 0 ? "PASSED" : "FAILED", gFailures);
+    return gFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,134 @@
+#include "UnitConversion.h"
+#include "Common/Log.h"
+
+#include <vector>
+
+double GetUnitFactor(FbxScene* pScene, const FbxSystemUnit& pTarget)
+{
+    return pScene->GetGlobalSettings().GetSystemUnit().GetConversionFactorTo(pTarget);
+}
+
+static void ScaleProperty(FbxPropertyT<FbxDouble3>& pProperty, double pFactor)
+{
+    const FbxDouble3 lValue = pProperty.Get();
+    if (lValue[0] != 0.0 || lValue[1] != 0.0 || lValue[2] != 0.0)
+        pProperty.Set(FbxDouble3(lValue[0] * pFactor, lValue[1] * pFactor, lValue[2] * pFactor));
+}
+
+static void ScaleTranslation(FbxAMatrix& pMatrix, double pFactor)
+{
+    FbxVector4 lTranslation = pMatrix.GetT();
+    lTranslation[0] *= pFactor;
+    lTranslation[1] *= pFactor;
+    lTranslation[2] *= pFactor;
+    pMatrix.SetT(lTranslation);
+}
+
+static void ScaleNodes(const SceneTable& pTable, double pFactor, UnitConversionResult& pResult)
+{
+    const std::vector<SceneTableNode>& lNodes = pTable.GetNodes();
+    const std::vector<SceneTableLayer>& lLayers = pTable.GetLayers();
+    for (size_t i = 0; i < lNodes.size(); ++i)
+    {
+        FbxNode* lNode = lNodes[i].mNode;
+        ScaleProperty(lNode->LclTranslation, pFactor);
+        ScaleProperty(lNode->RotationOffset, pFactor);
+        ScaleProperty(lNode->RotationPivot, pFactor);
+        ScaleProperty(lNode->ScalingOffset, pFactor);
+        ScaleProperty(lNode->ScalingPivot, pFactor);
+        ScaleProperty(lNode->GeometricTranslation, pFactor);
+
+        // The curve node default is what a channel holds where it has no curve.
+        for (size_t l = 0; l < lLayers.size(); ++l)
+        {
+            FbxAnimCurveNode* lCurveNode = lNode->LclTranslation.GetCurveNode(lLayers[l].mLayer);
+            if (!lCurveNode)
+                continue;
+            for (unsigned int c = 0; c < lCurveNode->GetChannelsCount(); ++c)
+                lCurveNode->SetChannelValue<double>(c, lCurveNode->GetChannelValue<double>(c, 0.0) * pFactor);
+        }
+        ++pResult.mNodes;
+    }
+}
+
+static void ScaleGeometries(FbxScene* pScene, double pFactor, UnitConversionResult& pResult)
+{
+    // Geometries are scene objects, so instances shared by several nodes are scaled once.
+    for (int i = 0, lCount = pScene->GetSrcObjectCount<FbxGeometryBase>(); i < lCount; ++i)
+    {
+        FbxGeometryBase* lGeometry = pScene->GetSrcObject<FbxGeometryBase>(i);
+        FbxVector4* lPoints = lGeometry->GetControlPoints();
+        const int lPointCount = lGeometry->GetControlPointsCount();
+        for (int p = 0; lPoints && p < lPointCount; ++p)
+        {
+            lPoints[p][0] *= pFactor;
+            lPoints[p][1] *= pFactor;
+            lPoints[p][2] *= pFactor;
+        }
+        ++pResult.mGeometries;
+        pResult.mControlPoints += lPointCount;
+    }
+}
+
+static void ScaleClusters(FbxScene* pScene, double pFactor, UnitConversionResult& pResult)
+{
+    // A uniform change of units only moves the translation of an affine matrix.
+    for (int i = 0, lCount = pScene->GetSrcObjectCount<FbxCluster>(); i < lCount; ++i)
+    {
+        FbxCluster* lCluster = pScene->GetSrcObject<FbxCluster>(i);
+        FbxAMatrix lMatrix;
+        lCluster->GetTransformMatrix(lMatrix);
+        ScaleTranslation(lMatrix, pFactor);
+        lCluster->SetTransformMatrix(lMatrix);
+        lCluster->GetTransformLinkMatrix(lMatrix);
+        ScaleTranslation(lMatrix, pFactor);
+        lCluster->SetTransformLinkMatrix(lMatrix);
+        lCluster->GetTransformAssociateModelMatrix(lMatrix);
+        ScaleTranslation(lMatrix, pFactor);
+        lCluster->SetTransformAssociateModelMatrix(lMatrix);
+        ++pResult.mClusters;
+    }
+}
+
+static void ScalePoses(FbxScene* pScene, double pFactor, UnitConversionResult& pResult)
+{
+    for (int i = 0; i < pScene->GetPoseCount(); ++i)
+    {
+        FbxPose* lPose = pScene->GetPose(i);
+
+        // Poses have no matrix setter, so every entry is removed and added back scaled.
+        std::vector<FbxNode*> lNodes;
+        std::vector<FbxMatrix> lMatrices;
+        std::vector<bool> lLocal;
+        for (int j = 0; j < lPose->GetCount(); ++j)
+        {
+            lNodes.push_back(lPose->GetNode(j));
+            lMatrices.push_back(lPose->GetMatrix(j));
+            lLocal.push_back(lPose->IsLocalMatrix(j));
+        }
+        for (int j = lPose->GetCount() - 1; j >= 0; --j)
+            lPose->Remove(j);
+
+        for (size_t j = 0; j < lNodes.size(); ++j)
+        {
+            FbxVector4 lRow = lMatrices[j].GetRow(3);
+            lRow[0] *= pFactor;
+            lRow[1] *= pFactor;
+            lRow[2] *= pFactor;
+            lMatrices[j].SetRow(3, lRow);
+            lPose->Add(lNodes[j], lMatrices[j], lLocal[j]);
+        }
+        ++pResult.mPoses;
+    }
+}
+
+void ApplyUnitFactor(FbxScene* pScene, const SceneTable& pTable, double pFactor, UnitConversionResult& pResult)
+{
+    ScaleNodes(pTable, pFactor, pResult);
+    ScaleGeometries(pScene, pFactor, pResult);
+    ScaleClusters(pScene, pFactor, pResult);
+    ScalePoses(pScene, pFactor, pResult);
+
+    LOG_INFO("Converted units by %f: %d nodes, %d geometries, %lld control points, %d clusters, %d poses\n",
+             pFactor, pResult.mNodes, pResult.mGeometries, pResult.mControlPoints, pResult.mClusters, pResult.mPoses);
+}
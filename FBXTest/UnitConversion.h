@@ -0,0 +1,39 @@
+#ifndef _UNIT_CONVERSION_H
+#define _UNIT_CONVERSION_H
+
+#include <fbxsdk.h>
+#include "SceneTable.h"
+
+struct UnitConversionResult
+{
+    UnitConversionResult() : mNodes(0), mGeometries(0), mControlPoints(0), mClusters(0), mPoses(0) {}
+
+    int mNodes;
+    int mGeometries;
+    long long mControlPoints;
+    int mClusters;
+    int mPoses;
+};
+
+/** Factor that converts lengths in the scene's system unit to pTarget. */
+double GetUnitFactor(FbxScene* pScene, const FbxSystemUnit& pTarget);
+
+/** Multiply every static length of a scene by pFactor, in place of
+  * FbxSystemUnit::ConvertScene.
+  *
+  * This covers node translations, pivots, offsets and geometric translations,
+  * the defaults of translation curve nodes on every layer, geometry control
+  * points, the translations of skin cluster matrices and of pose matrices.
+  * Animation keys are not touched: the pipeline folds the factor into the
+  * parent scale it applies to each translation curve, so every key is scaled
+  * once. Limb sizes are scaled by the rename pass the same way. Camera and
+  * light properties are not converted.
+  *
+  * /param pScene The scene to convert.
+  * /param pTable The scene's table, for nodes and layers.
+  * /param pFactor Length multiplier, usually from GetUnitFactor.
+  * /param pResult Receives counts of what was converted.
+  */
+void ApplyUnitFactor(FbxScene* pScene, const SceneTable& pTable, double pFactor, UnitConversionResult& pResult);
+
+#endif // #ifndef _UNIT_CONVERSION_H
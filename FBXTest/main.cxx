@@ -1,272 +1,239 @@
 #include "Common/Common.h"
-#include "DisplayCommon.h"
-#include "DisplayHierarchy.h"
-#include "DisplaySkeleton.h"
+#include "Common/Log.h"
+#include "Batch.h"
+#include "Benchmark.h"
+#include "Daemon.h"
+#include "MemoryTracker.h"
+#include "Pipeline.h"
+#include "RenameReport.h"
+#include "ResultCache.h"
+#include "SceneStats.h"
+#include "Native/NativeCommands.h"
 
-#include <iostream>
-#include <map>
-#include <istream>
-#include <sstream>
-#include <fstream>
+#include <cstdlib>
+#include <cstring>
 
-// Local function prototypes.
-void DisplayContent(FbxScene* pScene);
-void DisplayContent(FbxNode* pNode);
-void DisplayTarget(FbxNode* pNode);
-void DisplayTransformPropagation(FbxNode* pNode);
-void DisplayGeometricTransform(FbxNode* pNode);
-void DisplayMetaData(FbxScene* pScene);
-void ScaleCurves(FbxNode* pNode, FbxAnimLayer* pLayer, FbxVectorTemplate3<double> scale);
-
-static bool gVerbose = true;
-static bool removeAnim = false;
-std::map<std::string, std::string> jointMap;
+JointMap jointMap;
 
 
 int main(int argc, char** argv)
 {
+	// The handlers must be in place before the SDK allocates anything, and
+	// FbxString members below already do, so look for the flags with plain strcmp.
+	bool lMemoryStats = false;
+	bool lArena = false;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (strcmp(argv[i], "-memstats") == 0) lMemoryStats = true;
+		else if (strcmp(argv[i], "-arena") == 0) lArena = true;
+	}
+	if (lMemoryStats || lArena)
+		InstallAllocationTracker(lArena);
+
 	FbxManager* lSdkManager = NULL;
 	FbxScene* lScene = NULL;
 	bool lResult;
-
-
-	// Prepare the FBX SDK.
-	InitializeSdkObjects(lSdkManager, lScene);
-	// Load the scene.
+	PipelineOptions lOptions;
+	BatchOptions lBatchOptions;
+	bool lListOnly = false;
+	bool lStatsOnly = false;
+	std::string lProfileReport;
+	std::string lRenameReport;
+	std::string lOutputDirectory;
+	BenchmarkOptions lBenchmarkOptions;
+	bool lBenchmark = false;
+	bool lDaemon = false;
+	std::string lJointMapFile("jointmap.cfg");
+	std::string lCacheDirectory;
+	bool lCacheLink = false;
+	ResultCache lCache;
+
+	// Whatever the main thread logged is written out on every exit path.
+	atexit(LogFlush);
 
 	// The example can take a FBX file as an argument.
 	FbxString lFilePath("");
     const char* outpath = "output.fbx";
+    bool lOutputGiven = false;
 	for (int i = 1, c = argc; i < c; ++i)
 	{
-		if (FbxString(argv[i]) == "-test") gVerbose = false;
-        else if (FbxString(argv[i]) == "-removeanim") removeAnim = true;
+		if (FbxString(argv[i]) == "-test") SetLogLevel(eLogWarning);
+        else if (FbxString(argv[i]) == "-verbose") SetLogLevel(eLogTrace);
+        else if (FbxString(argv[i]) == "-loglevel" && i + 1 < c)
+        {
+            ELogLevel lLevel;
+            if (!ParseLogLevel(argv[++i], lLevel))
+            {
+                LOG_ERROR("Error: Unknown log level %s, use silent, error, warning, info or trace\n", argv[i]);
+                return 1;
+            }
+            SetLogLevel(lLevel);
+        }
+        else if (FbxString(argv[i]) == "-removeanim") lOptions.mRemoveAnim = true;
+        else if (FbxString(argv[i]) == "-list") lListOnly = true;
+        else if (FbxString(argv[i]) == "-stats") lStatsOnly = true;
+        else if (FbxString(argv[i]) == "-nativerename") lOptions.mNativeRename = true;
+        else if (FbxString(argv[i]) == "-ascii") lOptions.mExport.mFormat = ExportOptions::eAscii;
+        else if (FbxString(argv[i]) == "-binary") lOptions.mExport.mFormat = ExportOptions::eBinary;
+        else if (FbxString(argv[i]) == "-fbxversion" && i + 1 < c) lOptions.mExport.mVersion = argv[++i];
+        else if (FbxString(argv[i]) == "-compress" && i + 1 < c) lOptions.mExport.mCompressionLevel = atoi(argv[++i]);
+        else if (FbxString(argv[i]) == "-batch" && i + 1 < c) lBatchOptions.mInput = argv[++i];
+        else if (FbxString(argv[i]) == "-outdir" && i + 1 < c) lOutputDirectory = argv[++i];
+        else if (FbxString(argv[i]) == "-j" && i + 1 < c) lBatchOptions.mWorkers = atoi(argv[++i]);
+        else if (FbxString(argv[i]) == "-incremental" && i + 1 < c) lBatchOptions.mStateFile = argv[++i];
+        else if (FbxString(argv[i]) == "-scalethreads" && i + 1 < c) lOptions.mScaleThreads = atoi(argv[++i]);
+        else if (FbxString(argv[i]) == "-animscale") lOptions.mAnimatedScale = true;
+        else if (FbxString(argv[i]) == "-nativescale" && i + 1 < c) lOptions.mNativeScale = atof(argv[++i]);
+        else if (FbxString(argv[i]) == "-fuseunits") lOptions.mFuseUnits = true;
+        else if (FbxString(argv[i]) == "-bake" && i + 1 < c) lOptions.mBakeRate = atof(argv[++i]);
+        else if (FbxString(argv[i]) == "-reducekeys" && i + 1 < c) lOptions.mKeyTolerance = atof(argv[++i]);
+        else if (FbxString(argv[i]) == "-profile" && i + 1 < c) lProfileReport = argv[++i];
+        else if (FbxString(argv[i]) == "-report" && i + 1 < c) lRenameReport = argv[++i];
+        else if (FbxString(argv[i]) == "-daemon") lDaemon = true;
+        else if (FbxString(argv[i]) == "-takes" && i + 1 < c) AddTakePatterns(argv[++i], lOptions.mIncludeTakes);
+        else if (FbxString(argv[i]) == "-excludetakes" && i + 1 < c) AddTakePatterns(argv[++i], lOptions.mExcludeTakes);
+        else if (FbxString(argv[i]) == "-content" && i + 1 < c)
+        {
+            if (!ParseContentProfile(argv[++i], lOptions.mContent))
+            {
+                LOG_ERROR("Error: Unknown content profile %s, use full, anim or skeleton\n", argv[i]);
+                return 1;
+            }
+        }
+        else if (FbxString(argv[i]) == "-map" && i + 1 < c) lJointMapFile = argv[++i];
+        else if (FbxString(argv[i]) == "-cache" && i + 1 < c) lCacheDirectory = argv[++i];
+        else if (FbxString(argv[i]) == "-cachelink") lCacheLink = true;
+        else if (FbxString(argv[i]) == "-memstats" || FbxString(argv[i]) == "-arena") continue;
+        else if (FbxString(argv[i]) == "-benchmark")
+        {
+            lBenchmark = true;
+            if (i + 1 < c && argv[i + 1][0] != '-' && !ParseBenchmarkSpec(argv[++i], lBenchmarkOptions))
+                return 1;
+        }
 		else if (lFilePath.IsEmpty()) lFilePath = argv[i];
-        else if (!lFilePath.IsEmpty()) outpath = argv[i];
-	}
-
-	//Read joints file
-	std::ifstream jfile("jointmap.cfg");
-	std::stringstream is_file;
-	if (jfile)
-	{		
-		is_file << jfile.rdbuf();
-		jfile.close();
+        else if (!lFilePath.IsEmpty())
+        {
+            outpath = argv[i];
+            lOutputGiven = true;
+        }
 	}
 
-
-	std::string line;
-	while (std::getline(is_file, line))
+	if (!lOutputDirectory.empty())
 	{
-		std::cout << "Read line: " << line << std::endl;
-
-		std::istringstream is_line(line);
-		std::string key;
-		if (std::getline(is_line, key, '='))
-		{
-			std::string value;
-			if (std::getline(is_line, value))
-				jointMap[key] = value;
-		}
+		lBatchOptions.mOutputDirectory = lOutputDirectory;
+		lBenchmarkOptions.mOutputDirectory = lOutputDirectory;
 	}
 
-
-	if (lFilePath.IsEmpty())
-	{
-		lResult = false;
-		FBXSDK_printf("\n\nUsage: ImportScene <FBX file name>\n\n");
-	}
-	else
+	// The benchmark generates its own scene and joint map.
+	if (lBenchmark)
 	{
-		FBXSDK_printf("\n\nFile: %s\n\n", lFilePath.Buffer());
-		lResult = LoadScene(lSdkManager, lScene, lFilePath.Buffer());
+		lBenchmarkOptions.mProfileReport = lProfileReport;
+		return RunBenchmark(lBenchmarkOptions, lOptions) ? 0 : 1;
 	}
 
-	if (lResult == false)
+	// The benchmark above always runs the pipeline; everything else may use the cache.
+	if (!lCacheDirectory.empty())
 	{
-		FBXSDK_printf("\n\nAn error occurred while loading the scene...");
-	}
-	else
-	{
-		// Display the scene.
-		DisplayMetaData(lScene);		
-		DisplayContent(lScene);
-		
+		if (!lCache.Open(lCacheDirectory.c_str(), lCacheLink))
+		{
+			LOG_ERROR("Error: Unable to create cache directory %s\n", lCacheDirectory.c_str());
+			return 1;
+		}
+		lOptions.mCache = &lCache;
 	}
 
-    // Parse all the nodes to convert the translations and meshes vertices.
-    int numAnimStacks = lScene->GetSrcObjectCount(FbxCriteria::ObjectType(FbxAnimStack::ClassId));
-    for(int i = 0; i < numAnimStacks; ++i)
-    {
-        FbxAnimStack* stack = FbxCast<FbxAnimStack>(lScene->GetSrcObject(FbxCriteria::ObjectType(FbxAnimStack::ClassId), i));
-        FBXSDK_printf("Scaling Stack %s\n", stack->GetName());
+	// The daemon loads joint maps per request and keeps them.
+	if (lDaemon)
+		return RunDaemon(lOptions, lJointMapFile) ? 0 : 1;
 
-        int nbAnimLayers = stack->GetMemberCount(FbxCriteria::ObjectType(FbxAnimLayer::ClassId));
-        for(int j = 0; j < nbAnimLayers; ++j)
-        {
-            FbxAnimLayer* layer = FbxCast<FbxAnimLayer>(stack->GetMember(FbxCriteria::ObjectType(FbxAnimLayer::ClassId), j));
-            FBXSDK_printf("  Scaling Layer %s\n", layer->GetName());
-            ScaleCurves(lScene->GetRootNode(), layer, FbxVectorTemplate3<double>(1.0, 1.0, 1.0));
-        }
-    }
+	//Read joints file
+	jointMap.Load(lJointMapFile.c_str());
 
-    if (removeAnim)
-    {
-        for (int i = numAnimStacks - 1; i >= 0; --i)
-        {
-            FbxAnimStack* stack = FbxCast<FbxAnimStack>(lScene->GetSrcObject(FbxCriteria::ObjectType(FbxAnimStack::ClassId), i));
-            FBXSDK_printf("Removing Anim Stack %s\n", stack->GetName());
-            lScene->RemoveAnimStack(stack->GetName());
-        }
-    }
+	// Daemon responses already describe each job, so only batch and single runs write a report.
+	RenameReport lReport(GetReportFormat(lRenameReport.c_str()));
+	if (!lRenameReport.empty())
+		lOptions.mReport = &lReport;
 
-    FbxGlobalSettings& settings = lScene->GetGlobalSettings();
-    FbxSystemUnit::cm.ConvertScene(lScene);
-    settings.SetSystemUnit(FbxSystemUnit::cm);
-    lScene->GetAnimationEvaluator()->Reset();
+	if (!lBatchOptions.mInput.empty())
+	{
+		lBatchOptions.mProfileReport = lProfileReport;
+		lResult = RunBatch(lBatchOptions, lOptions, jointMap);
+		if (!lRenameReport.empty() && !lReport.Save(lRenameReport.c_str()))
+			LOG_ERROR("Error: Unable to write report %s\n", lRenameReport.c_str());
+		return lResult ? 0 : 1;
+	}
 
-	lResult = SaveScene(lSdkManager, lScene, outpath);
-	if (lResult == false)
+	if (lFilePath.IsEmpty())
 	{
-		FBXSDK_printf("\n\nAn error occurred while saving the scene...\n");
-		DestroySdkObjects(lSdkManager, lResult);
+		FBXSDK_printf("\n\nUsage: ImportScene <FBX file name> [output file name] [-removeanim] [-nativerename]\n"
+		              "       ImportScene -batch <directory|pattern|@manifest> [-outdir <directory>] [-j <workers>] [-incremental <state file>] [-removeanim] [-nativerename]\n"
+		              "       ImportScene -list <binary FBX file name>\n"
+		              "       ImportScene -stats <FBX file name> [report.json, default stdout]\n"
+		              "       ImportScene -benchmark [joints=200,depth=8,stacks=1,layers=1,keys=100,iterations=3] [-outdir <directory>]\n"
+		              "       ImportScene -daemon (JSON line requests on stdin, responses on stdout)\n"
+		              "Joint map: [-map <file, default jointmap.cfg>]\n"
+		              "Animation: [-scalethreads <n, 0 = all cores>] [-animscale] [-nativescale <factor, with -nativerename>] [-bake <fps>] [-reducekeys <cm and degrees>] [-fuseunits]\n"
+		              "Content: [-content full|anim|skeleton] [-takes <pattern,...>] [-excludetakes <pattern,...>]\n"
+		              "Cache: [-cache <directory>] [-cachelink]\n"
+		              "Output: [-binary|-ascii] [-fbxversion <e.g. FBX201400>] [-compress <0-9>]\n"
+		              "Logging: [-test] [-verbose] [-loglevel silent|error|warning|info|trace] [-profile <report.json>] [-memstats] [-arena]\n"
+		              "Report: [-report <renames.json|renames.ndjson>]\n\n");
 		return 0;
 	}
 
+	// Listing reads the binary file directly and never starts the SDK.
+	if (lListOnly)
+	{
+		LogFlush();
+		return ListSkeleton(lFilePath.Buffer(), jointMap) ? 0 : 1;
+	}
 
-
-	// Destroy all objects created by the FBX SDK.
-	DestroySdkObjects(lSdkManager, lResult);
-
-	return 0;
-}
-
-void ApplyComponentScale(FbxNode* pNode, FbxAnimLayer* pLayer, FbxVectorTemplate3<double>& scale, int component, const char* componentName)
-{
-    // Apply parent scale first
-    FbxAnimCurve* translation = pNode->LclTranslation.GetCurve(pLayer, componentName);
-    if(translation)
-    {
-        FBXSDK_printf("      Trans %s %s\n", componentName, pNode->GetName());
-        translation->KeyScaleValueAndTangent(scale[component]);
-    }
-
-    // Add local scale for child scaling
-    FbxAnimCurve* lclScale = pNode->LclScaling.GetCurve(pLayer, componentName);
-    if (lclScale)
-    {
-        FBXSDK_printf("      Scale %s %s\n", componentName, pNode->GetName());
-        scale[component] *= lclScale->GetValue();
-        lclScale->KeyClear();
-    }
-}
-
-void ScaleCurves(FbxNode* pNode, FbxAnimLayer* pLayer, FbxVectorTemplate3<double> scale)
-{
-    FBXSDK_printf("    Scaling %s\n", pNode->GetName());
-    ApplyComponentScale(pNode, pLayer, scale, 0, FBXSDK_CURVENODE_COMPONENT_X);
-    ApplyComponentScale(pNode, pLayer, scale, 1, FBXSDK_CURVENODE_COMPONENT_Y);
-    ApplyComponentScale(pNode, pLayer, scale, 2, FBXSDK_CURVENODE_COMPONENT_Z);
-
-    FBXSDK_printf("      New scale %f, %f, %f\n", scale[0], scale[1], scale[2]);
-
-    for (int i = 0; i < pNode->GetChildCount(); i++)
-    {
-        ScaleCurves(pNode->GetChild(i), pLayer, scale);
-    }
-}
-
-void DisplayContent(FbxScene* pScene)
-{
-	int i;
-	FbxNode* lNode = pScene->GetRootNode();
-
-	if (lNode)
+	// Statistics only load the scene; nothing is renamed or written.
+	if (lStatsOnly)
 	{
-		for (i = 0; i < lNode->GetChildCount(); i++)
-		{
-			DisplayContent(lNode->GetChild(i));
-		}
+		ImportOptions lImportOptions;
+		lImportOptions.mContent = lOptions.mContent;
+		lImportOptions.mIncludeTakes = lOptions.mIncludeTakes;
+		lImportOptions.mExcludeTakes = lOptions.mExcludeTakes;
+		// Without a report file stdout carries the JSON, so do not prompt on it.
+		lImportOptions.mPromptPassword = lOutputGiven;
+		return RunSceneStats(lFilePath.Buffer(), lImportOptions, lOutputGiven ? outpath : "") ? 0 : 1;
 	}
-}
 
-void DisplayContent(FbxNode* pNode)
-{
-	FbxNodeAttribute::EType lAttributeType;
-	int i;
+	FileProfile lProfile;
+	FileProfile* lProfilePointer = lProfileReport.empty() ? NULL : &lProfile;
 
-	if (pNode->GetNodeAttribute() == NULL)
+	// Native renaming patches the binary file directly and never starts the SDK.
+	if (lOptions.mNativeRename)
 	{
-		FBXSDK_printf("NULL Node Attribute\n\n");
+		lResult = ProcessFile(NULL, NULL, lFilePath.Buffer(), outpath, lOptions, jointMap, lProfilePointer);
 	}
 	else
 	{
-		lAttributeType = (pNode->GetNodeAttribute()->GetAttributeType());
-
-		switch (lAttributeType)
-		{
-		default:
-			break;
+		// Prepare the FBX SDK.
+		InitializeSdkObjects(lSdkManager, lScene);
 
-		case FbxNodeAttribute::eSkeleton:
-			DisplaySkeleton(pNode, jointMap);
-			break;
-
-		}
-	}
+		lResult = ProcessFile(lSdkManager, lScene, lFilePath.Buffer(), outpath, lOptions, jointMap, lProfilePointer);
 
-	for (i = 0; i < pNode->GetChildCount(); i++)
-	{
-		DisplayContent(pNode->GetChild(i));
+		// Destroy all objects created by the FBX SDK.
+		DestroySdkObjects(lSdkManager, lResult);
 	}
-}
-
 
+	if (lCache.IsOpen())
+		LOG_INFO("Result cache: %d hits, %d misses\n", lCache.GetHits(), lCache.GetMisses());
+	LogAllocationSummary();
 
+	if (!lRenameReport.empty() && !lReport.Save(lRenameReport.c_str()))
+		LOG_ERROR("Error: Unable to write report %s\n", lRenameReport.c_str());
 
-
-void DisplayMetaData(FbxScene* pScene)
-{
-	FbxDocumentInfo* sceneInfo = pScene->GetSceneInfo();
-	if (sceneInfo)
+	if (lProfilePointer)
 	{
-		FBXSDK_printf("\n\n--------------------\nMeta-Data\n--------------------\n\n");
-		FBXSDK_printf("    Title: %s\n", sceneInfo->mTitle.Buffer());
-		FBXSDK_printf("    Subject: %s\n", sceneInfo->mSubject.Buffer());
-		FBXSDK_printf("    Author: %s\n", sceneInfo->mAuthor.Buffer());
-		FBXSDK_printf("    Keywords: %s\n", sceneInfo->mKeywords.Buffer());
-		FBXSDK_printf("    Revision: %s\n", sceneInfo->mRevision.Buffer());
-		FBXSDK_printf("    Comment: %s\n", sceneInfo->mComment.Buffer());
-
-		FbxThumbnail* thumbnail = sceneInfo->GetSceneThumbnail();
-		if (thumbnail)
-		{
-			FBXSDK_printf("    Thumbnail:\n");
-
-			switch (thumbnail->GetDataFormat())
-			{
-			case FbxThumbnail::eRGB_24:
-				FBXSDK_printf("        Format: RGB\n");
-				break;
-			case FbxThumbnail::eRGBA_32:
-				FBXSDK_printf("        Format: RGBA\n");
-				break;
-			}
-
-			switch (thumbnail->GetSize())
-			{
-			default:
-				break;
-			case FbxThumbnail::eNotSet:
-				FBXSDK_printf("        Size: no dimensions specified (%ld bytes)\n", thumbnail->GetSizeInBytes());
-				break;
-			case FbxThumbnail::e64x64:
-				FBXSDK_printf("        Size: 64 x 64 pixels (%ld bytes)\n", thumbnail->GetSizeInBytes());
-				break;
-			case FbxThumbnail::e128x128:
-				FBXSDK_printf("        Size: 128 x 128 pixels (%ld bytes)\n", thumbnail->GetSizeInBytes());
-			}
-		}
+		std::vector<FileProfile> lProfiles(1, lProfile);
+		LogFlush();
+		PrintProfileReport(lProfiles);
+		if (!SaveProfileReport(lProfiles, lProfileReport.c_str()))
+			LOG_ERROR("Error: Unable to write profile report %s\n", lProfileReport.c_str());
 	}
-}
 
+	return lResult ? 0 : 1;
+}